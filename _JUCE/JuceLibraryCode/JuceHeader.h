@@ -17,9 +17,22 @@
 #include <chowdsp_core/chowdsp_core.h>
 #include <chowdsp_data_structures/chowdsp_data_structures.h>
 #include <chowdsp_dsp_data_structures/chowdsp_dsp_data_structures.h>
+#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
 #include <chowdsp_filters/chowdsp_filters.h>
+#include <chowdsp_gui/chowdsp_gui.h>
+#include <chowdsp_json/chowdsp_json.h>
+#include <chowdsp_listeners/chowdsp_listeners.h>
+#include <chowdsp_logging/chowdsp_logging.h>
 #include <chowdsp_math/chowdsp_math.h>
+#include <chowdsp_parameters/chowdsp_parameters.h>
+#include <chowdsp_plugin_base/chowdsp_plugin_base.h>
+#include <chowdsp_plugin_state/chowdsp_plugin_state.h>
+#include <chowdsp_presets_v2/chowdsp_presets_v2.h>
+#include <chowdsp_reflection/chowdsp_reflection.h>
+#include <chowdsp_serialization/chowdsp_serialization.h>
 #include <chowdsp_simd/chowdsp_simd.h>
+#include <chowdsp_version/chowdsp_version.h>
+#include <chowdsp_waveshapers/chowdsp_waveshapers.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_formats/juce_audio_formats.h>
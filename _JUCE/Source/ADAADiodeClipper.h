@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    ADAADiodeClipper.h
+
+    The GptScreamer exponential-knee clipper with 2nd-order antiderivative
+    anti-aliasing (ADAA), so that it can run at a much lower oversampling
+    factor than the plain clipper for the same amount of aliasing.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cmath>
+#include "DiodeClipper.h"
+#include "WDFDiodeClipper.h"
+
+//==============================================================================
+/**
+    chowdsp::ADAAWaveshaper loaded with the same curve as DiodeClipper,
+    f(x) = g(3x), and its first two antiderivatives in closed form:
+
+        g(v)  = v                                       |v| <= Vth
+              = s (Vth + (1 - e^(-kd)) / k)              otherwise, d = |v| - Vth
+
+        G1(v) = v^2 / 2                                 |v| <= Vth
+              = Vth^2/2 + Vth d + d/k - (1 - e^(-kd))/k^2
+
+        G2(v) = v^3 / 6                                 |v| <= Vth
+              = s (Vth^3/6 + Vth^2 d/2 + Vth d^2/2 + d^2/(2k) - d/k^2 + (1 - e^(-kd))/k^3)
+
+    and F1(x) = G1(3x) / 3, F2(x) = G2(3x) / 9.
+
+    Pass a chowdsp::SharedLookupTableCache so that the (fairly large) lookup
+    tables are only built once per process. Like all ADAA waveshapers this
+    adds one sample of latency (at the rate it runs at).
+
+    The tables cover +/- maxInput, i.e. the top of the DRIVE range with 12 dB
+    of headroom over full scale going into it. The tables clamp anything
+    outside that, which would flatten the antiderivatives and silence the
+    clipper, so the input must be clamped to +/- maxInput first (DriveChain
+    does this). The curve is flat that far out, so the clamp doesn't change
+    the output.
+*/
+template <typename T>
+class ADAADiodeClipper : public chowdsp::ADAAWaveshaper<T>
+{
+public:
+    static constexpr double inputHeadroom = 4.0; // +12 dB
+    static constexpr double maxInput = WDFDiodeClipper<double>::maxDriveGain * inputHeadroom;
+
+    explicit ADAADiodeClipper (chowdsp::LookupTableCache* lutCache = nullptr, T range = (T) maxInput, int N = 1 << 18)
+        : chowdsp::ADAAWaveshaper<T> (lutCache, "gpts_diode_clipper")
+    {
+        using Shape = DiodeClipper<ClipperAccuracy::Exact>;
+        static constexpr auto c = Shape::inputGain;
+        static constexpr auto Vth = Shape::Vth;
+        static constexpr auto k = Shape::k;
+
+        this->initialise (
+            [] (double x)
+            {
+                const auto v = c * x;
+                const auto d = std::abs (v) - Vth;
+                if (d <= 0.0)
+                    return v;
+                return std::copysign (Vth + (1.0 - std::exp (-k * d)) / k, v);
+            },
+            [] (double x)
+            {
+                const auto v = c * x;
+                const auto d = std::abs (v) - Vth;
+                if (d <= 0.0)
+                    return v * v / (2.0 * c);
+                return (Vth * Vth / 2.0 + Vth * d + d / k - (1.0 - std::exp (-k * d)) / (k * k)) / c;
+            },
+            [] (double x)
+            {
+                const auto v = c * x;
+                const auto d = std::abs (v) - Vth;
+                if (d <= 0.0)
+                    return v * v * v / (6.0 * c * c);
+                const auto G2 = Vth * Vth * Vth / 6.0 + Vth * Vth * d / 2.0 + Vth * d * d / 2.0
+                                + d * d / (2.0 * k) - d / (k * k) + (1.0 - std::exp (-k * d)) / (k * k * k);
+                return std::copysign (G2, v) / (c * c);
+            },
+            -range,
+            range,
+            N);
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ADAADiodeClipper)
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    BinaryState.h
+
+    Compact binary format for the GptScreamer plugin state, used by
+    getStateInformation() and setStateInformation().
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Reads and writes the parameters of a chowdsp::ParamHolder, and the
+    plugin's non-parameter state, as a small little-endian binary blob:
+
+        uint32  magic number ("GPTS")
+        uint16  format version
+        int32   plugin version hint (chowdsp::Version::getVersionHint())
+        uint16  number of parameters
+        then for each parameter:
+            uint8   length of the parameter ID
+            char[]  parameter ID (UTF-8, not null-terminated)
+            float   value, in the parameter's own units (choice index, 0/1 for bools)
+        uint32  size of the non-parameter state in bytes (format version 2 and up)
+        char[]  non-parameter state (e.g. the current preset), as the JSON
+                that chowdsp::NonParamState serializes itself to
+
+    Parameters are matched by ID, so states from older versions load with
+    any new parameters at their defaults, and unknown IDs are skipped.
+    Non-parameter values are matched by name in the same way, and states
+    from format version 1 leave them untouched. The stored plugin version
+    is handed back so that the caller can apply version streaming.
+*/
+namespace BinaryState
+{
+static constexpr juce::uint32 magicNumber = 0x53545047; // "GPTS" in little-endian
+static constexpr int formatVersion = 2;
+
+/** Returns true if the data starts like a binary state. */
+inline bool isBinaryState (const void* data, size_t sizeInBytes) noexcept
+{
+    return sizeInBytes >= sizeof (magicNumber) && juce::ByteOrder::littleEndianInt (data) == magicNumber;
+}
+
+/** Writes the parameters and non-parameter state to the memory block, replacing its contents. */
+inline void write (const chowdsp::ParamHolder& params, const chowdsp::NonParamState& nonParams, juce::MemoryBlock& data)
+{
+#if defined JucePlugin_VersionString
+    const auto pluginVersion = chowdsp::currentPluginVersion;
+#else
+    const auto pluginVersion = chowdsp::Version {};
+#endif
+
+    juce::MemoryOutputStream stream (data, false);
+    stream.writeInt ((int) magicNumber);
+    stream.writeShort ((short) formatVersion);
+    stream.writeInt (pluginVersion.getVersionHint());
+    stream.writeShort ((short) params.count());
+
+    params.doForAllParameters (
+        [&stream] (const juce::RangedAudioParameter& param, size_t)
+        {
+            const auto numIDBytes = juce::jmin ((int) param.paramID.getNumBytesAsUTF8(), 255);
+            stream.writeByte ((char) numIDBytes);
+            stream.write (param.paramID.toRawUTF8(), (size_t) numIDBytes);
+            stream.writeFloat (param.convertFrom0to1 (param.getValue()));
+        });
+
+    const auto nonParamsJSON = chowdsp::JSONSerializer::serialize<chowdsp::JSONSerializer, chowdsp::NonParamState> (nonParams).dump();
+    stream.writeInt ((int) nonParamsJSON.size());
+    stream.write (nonParamsJSON.data(), nonParamsJSON.size());
+}
+
+/**
+    Reads the parameters and non-parameter state from a binary state.
+    Parameters that aren't in the state are reset to their defaults.
+
+    Returns false (and leaves the state untouched) if the data isn't a
+    valid binary state.
+*/
+inline bool read (const juce::MemoryBlock& data, chowdsp::ParamHolder& params, chowdsp::NonParamState& nonParams, chowdsp::Version& pluginVersion)
+{
+    if (! isBinaryState (data.getData(), data.getSize()))
+        return false;
+
+    juce::MemoryInputStream stream (data, false);
+    stream.skipNextBytes (sizeof (magicNumber));
+
+    const auto stateFormatVersion = (int) stream.readShort();
+    if (stateFormatVersion > formatVersion)
+    {
+        jassertfalse; // this state was saved by a newer format than we know about!
+        return false;
+    }
+
+    const auto versionHint = stream.readInt();
+    const auto numParams = (int) (juce::uint16) stream.readShort();
+
+    // read everything first, so that a truncated state doesn't half-load
+    std::vector<std::pair<juce::String, float>> values;
+    values.reserve ((size_t) numParams);
+    for (int i = 0; i < numParams; ++i)
+    {
+        const auto numIDBytes = (size_t) (juce::uint8) stream.readByte();
+        if (stream.getNumBytesRemaining() < (juce::int64) (numIDBytes + sizeof (float)))
+            return false;
+
+        auto paramID = juce::String::fromUTF8 (static_cast<const char*> (data.getData()) + stream.getPosition(), (int) numIDBytes);
+        stream.skipNextBytes ((juce::int64) numIDBytes);
+        values.emplace_back (std::move (paramID), stream.readFloat());
+    }
+
+    chowdsp::json nonParamValues;
+    if (stateFormatVersion >= 2)
+    {
+        if (stream.getNumBytesRemaining() < (juce::int64) sizeof (juce::uint32))
+            return false;
+
+        const auto numJSONBytes = (juce::int64) (juce::uint32) stream.readInt();
+        if (stream.getNumBytesRemaining() < numJSONBytes)
+            return false;
+
+        const auto* jsonStart = static_cast<const char*> (data.getData()) + stream.getPosition();
+        nonParamValues = chowdsp::json::parse (jsonStart, jsonStart + numJSONBytes, nullptr, false);
+        if (nonParamValues.is_discarded())
+            return false;
+    }
+
+    pluginVersion = chowdsp::Version { versionHint / 10000, (versionHint / 100) % 100, versionHint % 100 };
+
+    params.doForAllParameters (
+        [&values] (juce::RangedAudioParameter& param, size_t)
+        {
+            for (const auto& [paramID, value] : values)
+            {
+                if (param.paramID == paramID)
+                {
+                    param.setValueNotifyingHost (param.convertTo0to1 (value));
+                    return;
+                }
+            }
+
+            param.setValueNotifyingHost (param.getDefaultValue());
+        });
+
+    if (stateFormatVersion >= 2)
+        chowdsp::JSONSerializer::deserialize<chowdsp::JSONSerializer, chowdsp::NonParamState> (nonParamValues, nonParams);
+
+    return true;
+}
+} // namespace BinaryState
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    DiodeClipper.h
+
+    The GptScreamer exponential-knee diode clipper, as a compile-time
+    kernel that works on scalars or xsimd batches.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cmath>
+
+//==============================================================================
+/** How the clipper's exponential tail is evaluated. */
+enum class ClipperAccuracy
+{
+    Exact,  // std::exp / xsimd::exp
+    High,   // 3rd-order chowdsp::PowApprox::exp
+    Medium, // 2nd-order chowdsp::PowApprox::exp
+    Low,    // 1st-order chowdsp::PowApprox::exp
+};
+
+//==============================================================================
+/**
+    Symmetric diode clipper: linear up to Vth, then an exponential knee
+    that settles at Vth + 1/k.
+
+        v = 3x
+        y = sign(v) * (min(|v|, Vth) + (1 - exp(-k * max(|v| - Vth, 0))) / k)
+
+    Written branch-free so that it vectorises: below the threshold the
+    exponential term is exp(0) = 1, so the tail vanishes.
+*/
+template <ClipperAccuracy accuracy = ClipperAccuracy::High>
+struct DiodeClipper
+{
+    static constexpr double inputGain = 3.0;
+    static constexpr double Vth = 0.55;
+    static constexpr double k = 8.0;
+
+    /** Clips a single float, double or xsimd::batch. */
+    template <typename T>
+    static inline T processSample (T x) noexcept
+    {
+        using NumericType = chowdsp::SampleTypeHelpers::NumericType<T>;
+        CHOWDSP_USING_XSIMD_STD (abs);
+        CHOWDSP_USING_XSIMD_STD (min);
+        CHOWDSP_USING_XSIMD_STD (max);
+        CHOWDSP_USING_XSIMD_STD (copysign);
+
+        const auto v = x * (NumericType) inputGain;
+        const auto a = abs (v);
+        const auto over = max (a - (NumericType) Vth, T ((NumericType) 0));
+        const auto tail = ((NumericType) 1 - expTail (over * (NumericType) -k)) * (NumericType) (1.0 / k);
+
+        return copysign (min (a, T ((NumericType) Vth)) + tail, v);
+    }
+
+    /** Clips a block in place, a full SIMD register at a time. */
+    template <typename T>
+    static void process (T* data, int numSamples) noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            using Vec = xsimd::batch<T>;
+            static constexpr auto vecSize = (int) Vec::size;
+
+            int n = 0;
+            for (; n + vecSize <= numSamples; n += vecSize)
+                processSample (xsimd::load_unaligned (data + n)).store_unaligned (data + n);
+
+            for (; n < numSamples; ++n)
+                data[n] = processSample (data[n]);
+        }
+        else
+        {
+            for (int n = 0; n < numSamples; ++n)
+                data[n] = processSample (data[n]);
+        }
+    }
+
+    /** The original per-sample WaveShaper lambda, kept as the reference implementation. */
+    static float reference (float x) noexcept
+    {
+        float v = x * 3;
+        double Vth = 0.55;
+        double k = 8.0;
+        double a = std::fabs (v);
+        double s = (v >= 0.0) ? 1.0 : -1.0;
+        if (a <= Vth) return v;
+        double tail = (1.0 - std::exp (-k * (a - Vth))) / k;
+        return static_cast<float> (s * (Vth + tail));
+    }
+
+private:
+    template <typename T>
+    static inline T expTail (T x) noexcept
+    {
+        if constexpr (accuracy == ClipperAccuracy::Exact)
+        {
+            CHOWDSP_USING_XSIMD_STD (exp);
+            return exp (x);
+        }
+        else
+        {
+            constexpr int order = accuracy == ClipperAccuracy::High ? 3 : (accuracy == ClipperAccuracy::Medium ? 2 : 1);
+            return chowdsp::PowApprox::exp<T, order> (x);
+        }
+    }
+};
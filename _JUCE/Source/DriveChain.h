@@ -0,0 +1,406 @@
+/*
+  ==============================================================================
+
+    DriveChain.h
+
+    Fused, single-pass version of the GptScreamer drive chain. Every stage
+    that used to be its own juce::dsp processor (and its own pass over the
+    oversampled buffer) is run here in a single loop, with the filter
+    states copied into locals for the duration of the loop so they stay
+    in registers.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "DiodeClipper.h"
+#include "WDFDiodeClipper.h"
+#include "ADAADiodeClipper.h"
+#include "StageProfiler.h"
+
+//==============================================================================
+/** Normalised first-order coefficients: y = b0 x + b1 x[n-1] - a1 y[n-1] */
+template <typename NumericType>
+struct FirstOrderCoefs
+{
+    NumericType b0 = (NumericType) 1;
+    NumericType b1 = (NumericType) 0;
+    NumericType a1 = (NumericType) 0;
+};
+
+/** Prewarped (bilinear) cutoff gain for the TPT filters: g = tan(pi fc / fs). */
+template <typename NumericType>
+NumericType prewarpedCutoff (NumericType fc, NumericType fs) noexcept
+{
+    return std::tan (juce::MathConstants<NumericType>::pi * fc / fs);
+}
+
+//==============================================================================
+/**
+    Runs inputHP -> preClipLP -> drive -> clipper -> preToneLP -> tone stack
+    -> outputHP over a block of (oversampled) audio in a single loop.
+
+    The static filters are first-order and use Transposed Direct Form II, so
+    each one only needs a single state variable per channel. The tone stack
+    is a single second-order TPT state-variable filter (see setToneStack()),
+    since its coefficients are ramped every sample when the tone changes,
+    and the TPT form stays well-behaved under that modulation.
+
+    The loop runs in chunks of `chunkSize` samples: the pre-clip filters
+    write the chunk, the (memoryless) clipper then runs over it a full SIMD
+    register at a time, and the post-clip filters finish it off while it is
+    still sitting in L1.
+
+    SampleType may also be an xsimd::batch, in which case each "channel" is
+    a SIMD register's worth of interleaved audio channels. The coefficients
+    are always scalar.
+
+    For scalar chains, the clipper stage can also be handed over to an ADAA
+    waveshaper (see setADAAClipper()), which keeps per-channel state of its
+    own and adds one sample of latency.
+
+    With GPTSCREAMER_PROFILE_STAGES on, each chunk's pre-clip, clipper and
+    post-clip passes are timed separately (see setProfiler()).
+
+    Or the input highpass, pre-clip lowpass, drive and clipper can all be
+    swapped for a wave digital filter model of the op-amp clipping stage
+    (see setWDFClipper()), which keeps the filters and the clipper as one
+    stateful circuit, and works for scalar and SIMD chains alike.
+*/
+template <typename SampleType, typename Clipper = DiodeClipper<>>
+class DriveChain
+{
+public:
+    using NumericType = chowdsp::SampleTypeHelpers::NumericType<SampleType>;
+    using Coefs = FirstOrderCoefs<NumericType>;
+
+    DriveChain() = default;
+
+    //==============================================================================
+    void prepare (int numChannels)
+    {
+        states.resize ((size_t) numChannels);
+        reset();
+    }
+
+    /** Clears the filter states, and jumps the tone stack straight to its target. */
+    void reset()
+    {
+        std::fill (states.begin(), states.end(), ChannelState {});
+
+        tone = toneTarget;
+        toneRampRemaining = 0;
+    }
+
+    //==============================================================================
+    // static filters, these are set once in prepareToPlay
+    void setInputHighPass (const Coefs& c) noexcept   { inputHP = c; }
+    void setPreClipLowPass (const Coefs& c) noexcept  { preClipLP = c; }
+    void setPreToneLowPass (const Coefs& c) noexcept  { preToneLP = c; }
+    void setOutputHighPass (const Coefs& c) noexcept  { outputHP = c; }
+
+    /**
+        Sets the tone stack, out = x - kBass * HPb(x) + kTreb * HPt(x), where
+        HPb and HPt are first-order highpasses with prewarped cutoffs gBass
+        and gTreb (see prewarpedCutoff()). Changes are ramped in linearly over
+        the tone ramp length.
+
+        In the prewarped s-domain (s = (1 - z^-1) / (1 + z^-1)) the two
+        branches share a denominator, so they merge into one second-order
+        filter with the exact same response:
+
+                 (1 - kBass + kTreb) s^2 + (gBass + gTreb - kBass gTreb + kTreb gBass) s + gBass gTreb
+          H(s) = -------------------------------------------------------------------------------------
+                                       s^2 + (gBass + gTreb) s + gBass gTreb
+
+        which is run as a TPT SVF with g = sqrt(gBass gTreb) and
+        2R = (gBass + gTreb) / g (always >= 2, i.e. two real poles), mixing
+        its highpass, bandpass and lowpass outputs.
+    */
+    void setToneStack (NumericType gBass, NumericType kBass, NumericType gTreb, NumericType kTreb) noexcept
+    {
+        const auto g = std::sqrt (gBass * gTreb);
+
+        toneTarget.g = g;
+        toneTarget.twoR = (gBass + gTreb) / g;
+        toneTarget.hpGain = (NumericType) 1 - kBass + kTreb;
+        toneTarget.bpGain = (gBass + gTreb - kBass * gTreb + kTreb * gBass) / g;
+        startToneRamp();
+    }
+
+    void setToneRampLength (int numSamples) noexcept { toneRampLength = std::max (numSamples, 1); }
+
+    /** Sets a constant drive gain, used when process() isn't given a per-sample one. */
+    void setDriveGain (NumericType newGain) noexcept
+    {
+        driveGain = newGain;
+        wdfClipper.setDriveGain (newGain);
+    }
+
+    /**
+        Runs the clipper stage through an ADAA waveshaper instead of `Clipper`,
+        or pass nullptr to go back to `Clipper`. The waveshaper must already be
+        prepared for at least as many channels as this chain, and its tables
+        must cover at least +/- ADAADiodeClipper::maxInput, which its input is
+        clamped to.
+
+        Only supported for scalar (float/double) chains.
+    */
+    void setADAAClipper (chowdsp::ADAAWaveshaper<SampleType>* newADAAClipper) noexcept { adaaClipper = newADAAClipper; }
+
+    /**
+        Runs everything up to the clipper through a WDFDiodeClipper instead,
+        which sets its drive pot from the drive gain. The input highpass
+        still makes the current into the feedback network, while the
+        pre-clip lowpass is replaced by the feedback capacitor.
+    */
+    void setWDFClipper (bool shouldUseWDFClipper) noexcept { useWDFClipper = shouldUseWDFClipper; }
+
+    /** Sets the rate the WDF clipper runs at, i.e. the oversampled rate. */
+    void setWDFSampleRate (NumericType sampleRate) noexcept { wdfClipper.prepare (sampleRate); }
+
+    /** Sets the profiler that the drive, clipper and tone stack passes are counted in (or nullptr). */
+    void setProfiler (StageProfiler* newProfiler) noexcept { profiler = newProfiler; }
+
+    //==============================================================================
+    /**
+        Processes every channel of a juce::dsp::AudioBlock in place.
+
+        If `driveGains` is given, it holds one drive gain per sample (shared
+        by every channel) to use instead of the constant one. Only pass it
+        while the drive is actually moving: the WDF clipper then has to
+        recalculate its coefficients once per chunk and ramp them, rather
+        than using a fixed set.
+    */
+    template <typename BlockType>
+    void process (BlockType& block, const NumericType* driveGains = nullptr) noexcept
+    {
+        jassert ((size_t) block.getNumChannels() <= states.size());
+
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            processChannel (block.getChannelPointer (ch), (int) block.getNumSamples(), (int) ch, driveGains);
+
+        finishBlock ((int) block.getNumSamples(), driveGains);
+    }
+
+    /** Processes an array of channels in place. */
+    void process (SampleType* const* data, int numChannels, int numSamples, const NumericType* driveGains = nullptr) noexcept
+    {
+        jassert ((size_t) numChannels <= states.size());
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            processChannel (data[ch], numSamples, ch, driveGains);
+
+        finishBlock (numSamples, driveGains);
+    }
+
+private:
+    using WDFClipper = WDFDiodeClipper<SampleType>;
+
+    // tone stack SVF: out = hpGain * hp + bpGain * bp + lp
+    struct ToneParams
+    {
+        NumericType g = 1, twoR = 2, hpGain = 1, bpGain = 0;
+
+        NumericType hpNormaliser() const noexcept { return (NumericType) 1 / ((NumericType) 1 + g * (twoR + g)); }
+    };
+
+    void processChannel (SampleType* data, int numSamples, int channel, const NumericType* driveGains) noexcept
+    {
+        // local copies so the compiler doesn't have to assume `data` aliases our members
+        const auto c_in = inputHP, c_pc = preClipLP, c_pt = preToneLP, c_out = outputHP;
+        const auto gain = driveGain;
+        [[maybe_unused]] auto* adaa = adaaClipper;
+        auto wdfCoefs = wdfClipper.getCoefficients();
+
+        // every channel starts from the same point on the tone ramp
+        auto t = tone;
+        auto h = t.hpNormaliser();
+        const auto dt = toneStep;
+        auto rampRemaining = toneRampRemaining;
+
+        auto& state = states[(size_t) channel];
+        auto z_in = state.inputHP, z_pc = state.preClipLP, z_pt = state.preToneLP;
+        auto s1 = state.toneS1, s2 = state.toneS2, z_out = state.outputHP;
+        auto z_wdf = state.wdfCapacitor;
+
+        const auto postClip = [&] (SampleType x)
+        {
+            const auto y = tick (c_pt, z_pt, x);
+
+            const auto hp = (y - (t.twoR + t.g) * s1 - s2) * h;
+            const auto bp = t.g * hp + s1;
+            s1 = t.g * hp + bp;
+            const auto lp = t.g * bp + s2;
+            s2 = t.g * bp + lp;
+
+            return tick (c_out, z_out, t.hpGain * hp + t.bpGain * bp + lp);
+        };
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            auto* x = data + start;
+            const auto numChunkSamples = std::min (chunkSize, numSamples - start);
+
+            if (useWDFClipper)
+            {
+                StageProfiler::Scope profile (profiler, StageProfiler::Clipper);
+                if (driveGains != nullptr)
+                {
+                    // ramp the coefficients linearly to the ones for the last drive gain in the chunk
+                    const auto target = wdfClipper.getCoefficients (driveGains[start + numChunkSamples - 1]);
+                    const auto scale = (NumericType) 1 / (NumericType) numChunkSamples;
+                    const typename WDFClipper::Coefficients step { (target.sourceGain - wdfCoefs.sourceGain) * scale,
+                                                                   (target.alpha - wdfCoefs.alpha) * scale,
+                                                                   (target.logRIsOverVt - wdfCoefs.logRIsOverVt) * scale };
+
+                    for (int n = 0; n < numChunkSamples; ++n)
+                    {
+                        wdfCoefs.sourceGain += step.sourceGain;
+                        wdfCoefs.alpha += step.alpha;
+                        wdfCoefs.logRIsOverVt += step.logRIsOverVt;
+                        x[n] = WDFClipper::processSample (x[n], tick (c_in, z_in, x[n]), z_wdf, wdfCoefs);
+                    }
+
+                    wdfCoefs = target;
+                }
+                else
+                {
+                    for (int n = 0; n < numChunkSamples; ++n)
+                        x[n] = WDFClipper::processSample (x[n], tick (c_in, z_in, x[n]), z_wdf, wdfCoefs);
+                }
+            }
+            else
+            {
+                {
+                    StageProfiler::Scope profile (profiler, StageProfiler::Drive);
+                    if (driveGains != nullptr)
+                    {
+                        const auto* g = driveGains + start;
+                        for (int n = 0; n < numChunkSamples; ++n)
+                            x[n] = tick (c_pc, z_pc, tick (c_in, z_in, x[n])) * g[n];
+                    }
+                    else
+                    {
+                        for (int n = 0; n < numChunkSamples; ++n)
+                            x[n] = tick (c_pc, z_pc, tick (c_in, z_in, x[n])) * gain;
+                    }
+                }
+
+                StageProfiler::Scope profile (profiler, StageProfiler::Clipper);
+                if constexpr (std::is_floating_point_v<SampleType>)
+                {
+                    if (adaa != nullptr)
+                    {
+                        // past the ends of the ADAA tables (see ADAADiodeClipper)
+                        constexpr auto maxInput = (SampleType) ADAADiodeClipper<SampleType>::maxInput;
+                        for (int n = 0; n < numChunkSamples; ++n)
+                            x[n] = std::clamp (x[n], -maxInput, maxInput);
+
+                        adaa->process (x, x, numChunkSamples, channel);
+                    }
+                    else
+                        Clipper::process (x, numChunkSamples);
+                }
+                else
+                {
+                    Clipper::process (x, numChunkSamples);
+                }
+            }
+
+            // ramping samples first, then the rest of the chunk with the tone held
+            StageProfiler::Scope profile (profiler, StageProfiler::ToneStack);
+            int n = 0;
+            for (const auto numRampSamples = std::min (rampRemaining, numChunkSamples); n < numRampSamples; ++n)
+            {
+                t.g += dt.g;
+                t.twoR += dt.twoR;
+                t.hpGain += dt.hpGain;
+                t.bpGain += dt.bpGain;
+                h = t.hpNormaliser();
+                x[n] = postClip (x[n]);
+            }
+
+            rampRemaining -= n;
+            if (rampRemaining == 0)
+            {
+                t = toneTarget;
+                h = t.hpNormaliser();
+            }
+
+            for (; n < numChunkSamples; ++n)
+                x[n] = postClip (x[n]);
+        }
+
+        state = { z_in, z_pc, z_pt, s1, s2, z_out, z_wdf };
+    }
+
+    void startToneRamp() noexcept
+    {
+        toneRampRemaining = toneRampLength;
+
+        const auto scale = (NumericType) 1 / (NumericType) toneRampLength;
+        toneStep = { (toneTarget.g - tone.g) * scale,
+                     (toneTarget.twoR - tone.twoR) * scale,
+                     (toneTarget.hpGain - tone.hpGain) * scale,
+                     (toneTarget.bpGain - tone.bpGain) * scale };
+    }
+
+    void finishBlock (int numSamples, const NumericType* driveGains) noexcept
+    {
+        // leave the WDF clipper's drive pot where the per-sample gains ended up
+        if (driveGains != nullptr && numSamples > 0)
+            wdfClipper.setDriveGain (driveGains[numSamples - 1]);
+
+        advanceToneRamp (numSamples);
+    }
+
+    void advanceToneRamp (int numSamples) noexcept
+    {
+        const auto numRampSamples = std::min (toneRampRemaining, numSamples);
+        toneRampRemaining -= numRampSamples;
+
+        if (toneRampRemaining == 0)
+        {
+            tone = toneTarget;
+            return;
+        }
+
+        const auto steps = (NumericType) numRampSamples;
+        tone.g += toneStep.g * steps;
+        tone.twoR += toneStep.twoR * steps;
+        tone.hpGain += toneStep.hpGain * steps;
+        tone.bpGain += toneStep.bpGain * steps;
+    }
+
+    static inline SampleType tick (const Coefs& c, SampleType& z, SampleType x) noexcept
+    {
+        const auto y = z + c.b0 * x;
+        z = c.b1 * x - c.a1 * y;
+        return y;
+    }
+
+    static constexpr int chunkSize = 64;
+
+    struct ChannelState
+    {
+        SampleType inputHP {}, preClipLP {}, preToneLP {}, toneS1 {}, toneS2 {}, outputHP {}, wdfCapacitor {};
+    };
+    std::vector<ChannelState> states;
+
+    Coefs inputHP, preClipLP, preToneLP, outputHP;
+    NumericType driveGain = 1;
+
+    ToneParams tone, toneTarget, toneStep;
+    int toneRampLength = 1, toneRampRemaining = 0;
+
+    chowdsp::ADAAWaveshaper<SampleType>* adaaClipper = nullptr;
+
+    WDFClipper wdfClipper;
+    bool useWDFClipper = false;
+
+    StageProfiler* profiler = nullptr;
+};
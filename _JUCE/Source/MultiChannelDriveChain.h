@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    MultiChannelDriveChain.h
+
+    Runs the GptScreamer drive chain over any number of channels, with the
+    channels interleaved into xsimd::batch lanes so that a stereo (or up to
+    one SIMD register wide) signal costs about the same as a mono one.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "DriveChain.h"
+
+//==============================================================================
+/**
+    Owns a scalar DriveChain and a SIMD DriveChain with the same settings,
+    for either float or double audio.
+
+    Mono blocks go straight through the scalar chain. Blocks with more
+    channels are interleaved into a chowdsp::Buffer<xsimd::batch<SampleType>>,
+    processed a SIMD register (i.e. up to Vec::size channels) at a time,
+    and deinterleaved back out again.
+
+    The ADAA clipper has no SIMD version, so while it is active every block
+    goes through the scalar chain a channel at a time.
+*/
+template <typename SampleType = float, typename Clipper = DiodeClipper<>>
+class MultiChannelDriveChain
+{
+public:
+    using Vec = xsimd::batch<SampleType>;
+    using Coefs = FirstOrderCoefs<SampleType>;
+    static constexpr int vecSize = (int) Vec::size;
+
+    MultiChannelDriveChain() = default;
+
+    //==============================================================================
+    /** Allocates the interleaved buffer, must be called off the audio thread. */
+    void prepare (int numChannels, int maxBlockSize)
+    {
+        const auto numSIMDChannels = (numChannels + vecSize - 1) / vecSize;
+
+        scalarChain.prepare (numChannels);
+        simdChain.prepare (numSIMDChannels);
+        simdBuffer.setMaxSize (numSIMDChannels, maxBlockSize);
+    }
+
+    void reset()
+    {
+        scalarChain.reset();
+        simdChain.reset();
+    }
+
+    //==============================================================================
+    void setInputHighPass (const Coefs& c) noexcept   { forEachChain ([&c] (auto& chain) { chain.setInputHighPass (c); }); }
+    void setPreClipLowPass (const Coefs& c) noexcept  { forEachChain ([&c] (auto& chain) { chain.setPreClipLowPass (c); }); }
+    void setPreToneLowPass (const Coefs& c) noexcept  { forEachChain ([&c] (auto& chain) { chain.setPreToneLowPass (c); }); }
+    void setOutputHighPass (const Coefs& c) noexcept  { forEachChain ([&c] (auto& chain) { chain.setOutputHighPass (c); }); }
+
+    void setToneStack (SampleType gBass, SampleType kBass, SampleType gTreb, SampleType kTreb) noexcept
+    {
+        forEachChain ([=] (auto& chain) { chain.setToneStack (gBass, kBass, gTreb, kTreb); });
+    }
+
+    void setToneRampLength (int numSamples) noexcept { forEachChain ([numSamples] (auto& chain) { chain.setToneRampLength (numSamples); }); }
+
+    void setDriveGain (SampleType newGain) noexcept { forEachChain ([newGain] (auto& chain) { chain.setDriveGain (newGain); }); }
+
+    /** See DriveChain::setADAAClipper(). */
+    void setADAAClipper (chowdsp::ADAAWaveshaper<SampleType>* newADAAClipper) noexcept
+    {
+        usingADAAClipper = newADAAClipper != nullptr;
+        scalarChain.setADAAClipper (newADAAClipper);
+    }
+
+    /** See DriveChain::setWDFClipper(). */
+    void setWDFClipper (bool shouldUseWDFClipper) noexcept { forEachChain ([=] (auto& chain) { chain.setWDFClipper (shouldUseWDFClipper); }); }
+    void setWDFSampleRate (SampleType sampleRate) noexcept { forEachChain ([=] (auto& chain) { chain.setWDFSampleRate (sampleRate); }); }
+
+    /** See DriveChain::setProfiler(). */
+    void setProfiler (StageProfiler* newProfiler) noexcept { forEachChain ([=] (auto& chain) { chain.setProfiler (newProfiler); }); }
+
+    //==============================================================================
+    /** Processes every channel of a juce::dsp::AudioBlock in place. See DriveChain::process(). */
+    template <typename BlockType>
+    void process (BlockType& block, const SampleType* driveGains = nullptr) noexcept
+    {
+        if (block.getNumChannels() == 1 || usingADAAClipper)
+        {
+            scalarChain.process (block, driveGains);
+            return;
+        }
+
+        const chowdsp::BufferView<SampleType> scalarBuffer { block };
+
+        chowdsp::copyToSIMDBuffer<SampleType, SampleType> (scalarBuffer, simdBuffer);
+        simdChain.process (simdBuffer.getArrayOfWritePointers(), simdBuffer.getNumChannels(), simdBuffer.getNumSamples(), driveGains);
+        chowdsp::copyFromSIMDBuffer<SampleType, SampleType> (simdBuffer, scalarBuffer);
+    }
+
+private:
+    template <typename Func>
+    void forEachChain (Func&& func) noexcept
+    {
+        func (scalarChain);
+        func (simdChain);
+    }
+
+    DriveChain<SampleType, Clipper> scalarChain;
+    DriveChain<Vec, Clipper> simdChain;
+    chowdsp::Buffer<Vec> simdBuffer;
+
+    bool usingADAAClipper = false;
+};
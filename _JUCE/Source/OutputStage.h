@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    OutputStage.h
+
+    Output safety stage for GptScreamer, run at the base sample rate after
+    the oversampler has decimated the signal.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/** What the output stage does to the signal. */
+enum class OutputStageMode
+{
+    Limiter, // same level and ceiling as juce::dsp::Limiter, at a fraction of the cost
+    Clipper, // hard clip at the ceiling, level-matched to Limiter
+};
+
+//==============================================================================
+/**
+    A lightweight replacement for juce::dsp::Limiter, designed for the
+    output of the drive chain.
+
+    In Limiter mode this has the same structure and settings as the JUCE
+    limiter: a 4:1 compressor at -10 dB (2 ms attack, 200 ms release), then
+    a brickwall stage at the threshold with the given release, makeup gain
+    back up to 0 dBFS, and a final clip at +/-1. The difference is that both
+    stages share a single loop, the compressor gain is computed with
+    chowdsp's log2/pow2 approximations rather than std::pow, and the
+    brickwall stage (ratio 1000, 1 us attack in JUCE) is computed directly
+    as threshold / envelope.
+
+    In Clipper mode the signal is hard-clipped at the threshold, after a
+    fixed makeup gain that matches its level to Limiter mode's, so that
+    switching modes doesn't jump in level. Since the limiter compresses
+    and the clipper doesn't, the match can only be on average: over the
+    DRIVE and TONE ranges, with plucked notes at -24 and -12 dBFS, the
+    limiter came out between 4 dB louder (quiet, clean signals, which get
+    the full makeup gain) and 3 dB quieter (hot, driven ones) than the
+    plain clipper, 1.1 dB louder on average.
+*/
+template <typename SampleType>
+class OutputStage
+{
+public:
+    OutputStage() = default;
+
+    //==============================================================================
+    void prepare (double sampleRate, int numChannels)
+    {
+        fs = sampleRate;
+        states.resize ((size_t) numChannels);
+        updateCoefficients();
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill (states.begin(), states.end(), ChannelState {});
+    }
+
+    void setMode (OutputStageMode newMode) noexcept { mode = newMode; }
+
+    /** Sets the ceiling/threshold in dB and the limiter release time in milliseconds. */
+    void setParameters (SampleType thresholdDB, SampleType releaseMs)
+    {
+        thresholdDecibels = thresholdDB;
+        releaseTimeMs = releaseMs;
+        updateCoefficients();
+    }
+
+    //==============================================================================
+    /** Processes every channel of a juce::dsp::AudioBlock in place. */
+    template <typename BlockType>
+    void process (BlockType& block) noexcept
+    {
+        jassert ((size_t) block.getNumChannels() <= states.size());
+
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+        {
+            auto* data = block.getChannelPointer (ch);
+            const auto numSamples = (int) block.getNumSamples();
+
+            if (mode == OutputStageMode::Clipper)
+            {
+                for (int n = 0; n < numSamples; ++n)
+                    data[n] = std::clamp (data[n] * clipperMakeupGain, -threshold, threshold);
+            }
+            else
+            {
+                processLimiter (data, numSamples, states[ch]);
+            }
+        }
+    }
+
+private:
+    struct ChannelState
+    {
+        SampleType compEnvelope {}, limitEnvelope {};
+    };
+
+    void processLimiter (SampleType* data, int numSamples, ChannelState& state) const noexcept
+    {
+        auto env1 = state.compEnvelope, env2 = state.limitEnvelope;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            // stage 1: 4:1 compressor
+            const auto a1 = std::abs (data[n]);
+            env1 = a1 + (a1 > env1 ? compAttack : compRelease) * (env1 - a1);
+
+            auto y = data[n];
+            if (env1 > compThreshold)
+                y *= chowdsp::PowApprox::pow2 (compExponent * chowdsp::LogApprox::log2 (env1 * compThresholdInverse));
+
+            // stage 2: brickwall at the threshold (instant attack)
+            const auto a2 = std::abs (y);
+            env2 = a2 > env2 ? a2 : a2 + limitRelease * (env2 - a2);
+
+            if (env2 > threshold)
+                y *= threshold / env2;
+
+            data[n] = std::clamp (y * makeupGain, (SampleType) -1, (SampleType) 1);
+        }
+
+        state = { env1, env2 };
+    }
+
+    void updateCoefficients()
+    {
+        // same as juce::dsp::BallisticsFilter: exp (-2 pi * 1000 / (timeMs * fs))
+        const auto ballistics = [this] (double timeMs) { return (SampleType) std::exp (-juce::MathConstants<double>::twoPi * 1000.0 / (timeMs * fs)); };
+
+        compAttack = ballistics (compAttackMs);
+        compRelease = ballistics (compReleaseMs);
+        limitRelease = ballistics ((double) releaseTimeMs);
+
+        compThreshold = juce::Decibels::decibelsToGain ((SampleType) compThresholdDB);
+        compThresholdInverse = (SampleType) 1 / compThreshold;
+        threshold = juce::Decibels::decibelsToGain (thresholdDecibels);
+
+        // makeup gain, as juce::dsp::Limiter::update()
+        makeupGain = (SampleType) std::pow (10.0, 10.0 * (1.0 - 1.0 / compRatio) / 40.0)
+                     * juce::Decibels::decibelsToGain (-thresholdDecibels, (SampleType) -100);
+        clipperMakeupGain = juce::Decibels::decibelsToGain ((SampleType) clipperMakeupDB);
+    }
+
+    static constexpr double compThresholdDB = -10.0;
+    static constexpr double compRatio = 4.0;
+    static constexpr double compAttackMs = 2.0;
+    static constexpr double compReleaseMs = 200.0;
+    static constexpr auto compExponent = (SampleType) (1.0 / compRatio - 1.0);
+    static constexpr double clipperMakeupDB = 1.0; // see the class description
+
+    OutputStageMode mode = OutputStageMode::Limiter;
+    SampleType thresholdDecibels = (SampleType) -10, releaseTimeMs = (SampleType) 100;
+    double fs = 48000.0;
+
+    SampleType compAttack {}, compRelease {}, limitRelease {};
+    SampleType compThreshold = (SampleType) 1, compThresholdInverse = (SampleType) 1;
+    SampleType threshold = (SampleType) 1, makeupGain = (SampleType) 1, clipperMakeupGain = (SampleType) 1;
+
+    std::vector<ChannelState> states;
+};
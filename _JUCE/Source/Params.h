@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    Params.h
+
+    The GptScreamer parameters, held in a chowdsp::PluginState so that the
+    processor can keep typed handles to them instead of looking them up by
+    name.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+struct GptScreamerParams : chowdsp::ParamHolder
+{
+    using Oversampling = chowdsp::VariableOversampling<float>;
+
+    GptScreamerParams()
+    {
+        add (tone,
+             drive,
+             clipper,
+             output,
+             lowLatency,
+             firOversampling,
+             osFactor,
+             osMode,
+             osRenderFactor,
+             osRenderMode,
+             osRenderLikeRealtime);
+    }
+
+    // Range 0.0 to 1.0
+    chowdsp::FloatParameter::Ptr tone {
+        juce::ParameterID { "TONE", 1 },
+        "Tone",
+        juce::NormalisableRange { 0.0f, 1.0f, 0.001f },
+        0.5f,
+        &chowdsp::ParamUtils::floatValToString,
+        &chowdsp::ParamUtils::stringToFloatVal
+    };
+
+    // Range 0 dB to 30 dB
+    chowdsp::GainDBParameter::Ptr drive {
+        juce::ParameterID { "DRIVE", 1 },
+        "Drive",
+        juce::NormalisableRange { 0.0f, 30.0f, 0.1f, 1.0f },
+        0.0f
+    };
+
+    // "ADAA" uses the anti-derivative anti-aliased clipper, which at 2x
+    // aliases about as little as "Classic" does at 8x, and "WDF" models the
+    // whole op-amp clipping stage as a circuit (see WDFDiodeClipper). The
+    // WDF drive chain costs about 3.5x as much per sample as "Classic" (55
+    // vs 16 ns at 192 kHz), for any number of channels up to one SIMD
+    // register wide, since the channels are processed in parallel lanes
+    chowdsp::ChoiceParameter::Ptr clipper {
+        juce::ParameterID { "CLIPPER", 1 },
+        "Clipper",
+        juce::StringArray { "Classic", "ADAA", "WDF" },
+        0
+    };
+
+    // "Limiter" keeps the level and ceiling of the old juce::dsp::Limiter,
+    // "Clipper" is a hard clip at the ceiling, with a makeup gain to match
+    // the limiter's level (see OutputStage)
+    chowdsp::ChoiceParameter::Ptr output {
+        juce::ParameterID { "OUTPUT", 1 },
+        "Output",
+        juce::StringArray { "Limiter", "Clipper" },
+        0
+    };
+
+    // "Low Latency" swaps the oversampling filters for minimum-phase IIR ones,
+    // with under a sample of delay at 48 kHz, for monitoring through the
+    // plugin live (see LowLatencyOversampling)
+    chowdsp::BoolParameter::Ptr lowLatency {
+        juce::ParameterID { "LOW_LATENCY", 1 },
+        "Low Latency",
+        false
+    };
+
+    // "FIR Oversampling" swaps them for linear-phase polyphase FIR filters
+    // instead, for mastering, at the cost of 31 samples of latency (see
+    // FIROversampling). "Low Latency" wins if both are on
+    chowdsp::BoolParameter::Ptr firOversampling {
+        juce::ParameterID { "FIR_OVERSAMPLING", 1 },
+        "FIR Oversampling",
+        false
+    };
+
+    // Oversampling: the same IDs, names and choices that
+    // chowdsp::VariableOversampling::createParameterLayout() would make
+    // (defaults to 8x, min. phase)
+    chowdsp::ChoiceParameter::Ptr osFactor {
+        juce::ParameterID { "os_factor", 1 },
+        "Oversampling Factor",
+        Oversampling::getOSFactorChoices(),
+        3
+    };
+
+    chowdsp::ChoiceParameter::Ptr osMode {
+        juce::ParameterID { "os_mode", 1 },
+        "Oversampling Mode",
+        Oversampling::getOSModeChoices(),
+        0
+    };
+
+    chowdsp::ChoiceParameter::Ptr osRenderFactor {
+        juce::ParameterID { "os_render_factor", 1 },
+        "Oversampling Factor (render)",
+        Oversampling::getOSFactorChoices(),
+        3
+    };
+
+    chowdsp::ChoiceParameter::Ptr osRenderMode {
+        juce::ParameterID { "os_render_mode", 1 },
+        "Oversampling Mode (render)",
+        Oversampling::getOSModeChoices(),
+        0
+    };
+
+    chowdsp::BoolParameter::Ptr osRenderLikeRealtime {
+        juce::ParameterID { "os_render_like_realtime", 1 },
+        "Oversampling (render like real-time)",
+        true
+    };
+
+    /** Handles for constructing the VariableOversampling. */
+    Oversampling::ParameterHandles getOversamplingParameters()
+    {
+        return { osFactor.get(), osMode.get(), osRenderFactor.get(), osRenderMode.get(), osRenderLikeRealtime.get() };
+    }
+};
+
+using GptScreamerState = chowdsp::PluginStateImpl<GptScreamerParams>;
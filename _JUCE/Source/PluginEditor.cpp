@@ -11,11 +11,38 @@
 
 //==============================================================================
 GptScreamerAudioProcessorEditor::GptScreamerAudioProcessorEditor (GptScreamerAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p),
+      audioProcessor (p),
+      toneAttachment (*p.getState().params.tone, p.getState(), toneSlider),
+      driveAttachment (*p.getState().params.drive, p.getState(), driveSlider),
+      cpuMeter (p.getLoadMeasurer())
 {
+    // the controls are only set up here, paint() just draws the cached background
+    for (auto* slider : { &toneSlider, &driveSlider })
+    {
+        slider->setSliderStyle (juce::Slider::Rotary);
+        slider->setTextBoxStyle (juce::Slider::TextBoxBelow, true, 50, 20);
+        addAndMakeVisible (slider);
+    }
+
+    addAndMakeVisible (cpuMeter);
+
+    if constexpr (StageProfiler::isEnabled)
+    {
+        stageProfileLabel.setFont (juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+        stageProfileLabel.setJustificationType (juce::Justification::topLeft);
+        addAndMakeVisible (stageProfileLabel);
+
+        lastProfile = lastLoggedProfile = audioProcessor.getStageProfiler().getSnapshot();
+        startTimerHz (ticksPerSecond);
+    }
+
+    // the background image covers every pixel, so nothing behind us needs repainting
+    setOpaque (true);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (400, StageProfiler::isEnabled ? 420 : 300);
 }
 
 GptScreamerAudioProcessorEditor::~GptScreamerAudioProcessorEditor()
@@ -25,22 +52,40 @@ GptScreamerAudioProcessorEditor::~GptScreamerAudioProcessorEditor()
 //==============================================================================
 void GptScreamerAudioProcessorEditor::paint (juce::Graphics& g)
 {
-    // 1. Set up the Tone Slider
-    toneSlider.setSliderStyle(juce::Slider::Rotary);
-    toneSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 50, 20);
-    addAndMakeVisible(toneSlider);
-    toneAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment(
-        *audioProcessor.apvts, "TONE", toneSlider));
-
-    // 2. Set up the Drive Slider
-    driveSlider.setSliderStyle(juce::Slider::Rotary);
-    driveSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 50, 20);
-    addAndMakeVisible(driveSlider);
-    driveAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment(
-        *audioProcessor.apvts, "DRIVE", driveSlider));
-    
+    if (background.isNull())
+        renderBackground();
+
+    g.drawImage (background, getLocalBounds().toFloat());
+}
+
+void GptScreamerAudioProcessorEditor::lookAndFeelChanged()
+{
+    background = {};
+    repaint();
+}
+
+void GptScreamerAudioProcessorEditor::renderBackground()
+{
+    // rendered at the display's scale, so that it stays sharp on high-DPI screens
+    const auto scale = juce::Component::getApproximateScaleFactorForComponent (this);
+    background = juce::Image (juce::Image::RGB,
+                              juce::jmax (1, juce::roundToInt ((float) getWidth() * scale)),
+                              juce::jmax (1, juce::roundToInt ((float) getHeight() * scale)),
+                              false);
+
+    juce::Graphics g (background);
+    g.addTransform (juce::AffineTransform::scale (scale));
+
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+
+    g.setColour (getLookAndFeel().findColour (juce::Label::textColourId));
+    g.setFont (juce::FontOptions (20.0f, juce::Font::bold));
+    g.drawText ("GptScreamer", 0, 10, getWidth(), 30, juce::Justification::centred);
+
+    g.setFont (juce::FontOptions (14.0f));
+    g.drawText ("TONE", toneSlider.getBounds().withHeight (20).translated (0, -20), juce::Justification::centred);
+    g.drawText ("DRIVE", driveSlider.getBounds().withHeight (20).translated (0, -20), juce::Justification::centred);
 }
 
 void GptScreamerAudioProcessorEditor::resized()
@@ -50,4 +95,43 @@ void GptScreamerAudioProcessorEditor::resized()
         
     // Set bounds for the Drive Slider (e.g., in the top right quadrant)
     driveSlider.setBounds(200, 50, 150, 190);
+
+    cpuMeter.setBounds(50, 255, 300, 20);
+    stageProfileLabel.setBounds(50, 285, 300, 125);
+
+    // the captions follow the sliders, so redraw the background on the next paint
+    background = {};
+}
+
+void GptScreamerAudioProcessorEditor::timerCallback()
+{
+    // each stage's share of the time since the last tick
+    const auto profile = audioProcessor.getStageProfiler().getSnapshot();
+
+    juce::uint64 totalNanoseconds = 0;
+    for (size_t i = 0; i < (size_t) StageProfiler::numStages; ++i)
+        totalNanoseconds += profile.nanoseconds[i] - lastProfile.nanoseconds[i];
+    const auto numSamples = profile.numSamples - lastProfile.numSamples;
+
+    if (totalNanoseconds > 0 && numSamples > 0)
+    {
+        juce::String text;
+        for (size_t i = 0; i < (size_t) StageProfiler::numStages; ++i)
+        {
+            const auto stageNanoseconds = (double) (profile.nanoseconds[i] - lastProfile.nanoseconds[i]);
+            text << juce::String (StageProfiler::stageNames[i]).paddedRight (' ', 12)
+                 << juce::String (100.0 * stageNanoseconds / (double) totalNanoseconds, 1).paddedLeft (' ', 5) << "%  "
+                 << juce::String (stageNanoseconds / (double) numSamples, 1) << " ns/smp\n";
+        }
+        stageProfileLabel.setText (text, juce::dontSendNotification);
+    }
+    lastProfile = profile;
+
+    // and a longer-term summary in the log
+    if (++numTicksSinceLogged >= ticksPerSecond * logIntervalSeconds)
+    {
+        StageProfiler::log (lastLoggedProfile, profile);
+        lastLoggedProfile = profile;
+        numTicksSinceLogged = 0;
+    }
 }
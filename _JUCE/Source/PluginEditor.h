@@ -14,7 +14,8 @@
 //==============================================================================
 /**
 */
-class GptScreamerAudioProcessorEditor  : public juce::AudioProcessorEditor
+class GptScreamerAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                         private juce::Timer
 {
 public:
     GptScreamerAudioProcessorEditor (GptScreamerAudioProcessor&);
@@ -23,16 +24,33 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+    void lookAndFeelChanged() override;
 
 private:
+    void timerCallback() override;
+    void renderBackground();
+
+    GptScreamerAudioProcessor& audioProcessor;
+
     juce::Slider toneSlider;
     juce::Slider driveSlider;
         
-    // Attachments connect the Slider's position to the APVTS value
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> toneAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> driveAttachment;
+    // Attachments connect the Slider's position to the parameter value
+    chowdsp::SliderAttachment toneAttachment;
+    chowdsp::SliderAttachment driveAttachment;
     
-    GptScreamerAudioProcessor& audioProcessor;
+    // everything that doesn't move, drawn once per size (or look-and-feel) change
+    // rather than on every repaint
+    juce::Image background;
+
+    chowdsp::CPUMeter cpuMeter;
+
+    // per-stage breakdown, only in GPTSCREAMER_PROFILE_STAGES builds
+    juce::Label stageProfileLabel;
+    StageProfiler::Snapshot lastProfile, lastLoggedProfile;
+    int numTicksSinceLogged = 0;
+    static constexpr int ticksPerSecond = 4;
+    static constexpr int logIntervalSeconds = 10;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GptScreamerAudioProcessorEditor)
 };
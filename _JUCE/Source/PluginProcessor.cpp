@@ -11,125 +11,241 @@
 #include "PluginEditor.h"
 
 //==============================================================================
+template <typename FloatType>
+GptScreamerAudioProcessor::DSPChain<FloatType>::DSPChain(GptScreamerAudioProcessor& processor, chowdsp::LookupTableCache& lutCache)
+    : oversampling { processor, processor.state.params.getOversamplingParameters(), true },
+      adaaClipper { &lutCache }
+{
+}
 
 GptScreamerAudioProcessor::GptScreamerAudioProcessor()
-//#ifndef JucePlugin_PreferredChannelConfigurations
-//     : AudioProcessor (BusesProperties()
-//                       .withInput  ("Input",  juce::AudioChannelSet::mono(), true)
-//                       .withOutput ("Output", juce::AudioChannelSet::mono(), true)
-//                       )
-//#endif
 {
-    clipper.functionToUse = [](float x) {
-//        DBG("input x is: " << x);
-        float v = x * 3;
-        double Vth = 0.55;
-        double k = 8.0;
-        double a = fabs(v);
-        double s = (v >= 0.0) ? 1.0 : -1.0;
-        if (a <= Vth) return v;
-        double tail = (1.0 - std::exp(-k * (a - Vth))) / k;
-        return static_cast<float>(s * (Vth + tail));
+    // the drive is set in dB, but smoothed as a gain
+    const auto setupDriveGain = [this] (auto& driveGain)
+    {
+        driveGain.mappingFunction = [] (auto gainDB) { return juce::Decibels::decibelsToGain (gainDB); };
+        driveGain.setParameterHandle(state.params.drive.get());
+        driveGain.setRampLength(driveRampSeconds);
     };
-//    clipper.functionToUse = [](float x) { return std::tanh(x); };
-//    clipper.functionToUse = [](float x) { return antiParallel1N914(x); };
-    
-    apvts.reset(new juce::AudioProcessorValueTreeState(*this, nullptr, "Parameters", createParameterLayout()));
+    setupDriveGain(floatChain.driveGain);
+    setupDriveGain(doubleChain.driveGain);
+
+    setupPresets();
 }
 
-GptScreamerAudioProcessor::~GptScreamerAudioProcessor() {}
+GptScreamerAudioProcessor::~GptScreamerAudioProcessor()
+{
+    // totals for the whole session
+    StageProfiler::log ({}, stageProfiler.getSnapshot());
+}
 
 //==============================================================================
-const juce::String GptScreamerAudioProcessor::getName() const { return JucePlugin_Name; }
+// first-order filter coefficients, computed in place (no heap allocation, safe on the audio thread)
+template <typename T>
+static FirstOrderCoefs<T> firstOrderHighPass (T fc, T fs) noexcept
+{
+    T b[2], a[2];
+    chowdsp::CoefficientCalculators::calcFirstOrderHPF (b, a, fc, fs);
+    return { b[0], b[1], a[1] };
+}
 
-bool GptScreamerAudioProcessor::acceptsMidi() const { return false; }
+template <typename T>
+static FirstOrderCoefs<T> firstOrderLowPass (T fc, T fs) noexcept
+{
+    T b[2], a[2];
+    chowdsp::CoefficientCalculators::calcFirstOrderLPF (b, a, fc, fs);
+    return { b[0], b[1], a[1] };
+}
 
-bool GptScreamerAudioProcessor::producesMidi() const { return false; }
+void GptScreamerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    numChannels = juce::jmax(1, getTotalNumInputChannels());
+    baseSampleRate = sampleRate;
+    maxBlockSize = samplesPerBlock;
+    silentSamples = 0;
+    loadMeasurer.reset(sampleRate, samplesPerBlock);
+
+    // the float chain's clipper is the one that started loading the shared
+    // lookup tables, so wait for them there, whichever chain is used
+    floatChain.adaaClipper.prepare(numChannels);
+
+    if (isUsingDoublePrecision())
+        prepareChain(doubleChain);
+    else
+        prepareChain(floatChain);
+}
 
-bool GptScreamerAudioProcessor::isMidiEffect() const { return false; }
+template <typename FloatType>
+void GptScreamerAudioProcessor::prepareChain(DSPChain<FloatType>& chain)
+{
+    // Prepare all our components
+    chain.oversampling.prepareToPlay(baseSampleRate, maxBlockSize, numChannels);
+    chain.lowLatencyOversampling.prepare(baseSampleRate, maxBlockSize, numChannels);
+    chain.firOversampling.prepare(baseSampleRate, maxBlockSize, numChannels);
+    chain.driveChain.prepare(numChannels, maxBlockSize * maxOversamplingFactor);
+    chain.driveChain.setADAAClipper(useADAAClipper ? &chain.adaaClipper : nullptr);
+    chain.driveChain.setWDFClipper(useWDFClipper);
+    chain.driveChain.setProfiler(&stageProfiler);
+    chain.adaaClipper.prepare(numChannels);
+    chain.outputStage.prepare(baseSampleRate, numChannels); // runs at the base rate
+    chain.outputStage.setParameters ((FloatType) -0.3, (FloatType) 50); // dB, ms
+
+    // sets the oversampled rate, and all the filters that depend on it
+    chain.oversampling.updateOSFactor();
+    oversamplingFactorChanged(chain);
+}
+
+template <typename FloatType>
+void GptScreamerAudioProcessor::oversamplingFactorChanged(DSPChain<FloatType>& chain)
+{
+    const int osFactor = chain.oversampling.getOSFactor();
+    chain.lowLatencyOversampling.setOSFactor(osFactor);
+    chain.firOversampling.setOSFactor(osFactor);
+    oversampledRate = (float) baseSampleRate * (float) osFactor;
+    const auto fs = (FloatType) baseSampleRate * (FloatType) osFactor;
+
+    // the drive is applied at the oversampled rate (the buffer is allocated
+    // for the largest factor up front, so this never re-allocates)
+    chain.driveGain.prepare(fs, maxBlockSize * maxOversamplingFactor);
+
+    // set static filter values
+    auto& driveChain = chain.driveChain;
+    driveChain.setInputHighPass(firstOrderHighPass((FloatType) input_HP_Fc, fs));
+    driveChain.setPreClipLowPass(firstOrderLowPass((FloatType) pre_clip_LP_Fc, fs));
+    driveChain.setPreToneLowPass(firstOrderLowPass((FloatType) pre_tone_LP_Fc, fs));
+    driveChain.setOutputHighPass(firstOrderHighPass((FloatType) output_HP_Fc, fs));
+    driveChain.setWDFSampleRate(fs);
+
+    // set dynamic shelf values (tone changes are ramped in per sample)
+    driveChain.setToneRampLength(juce::roundToInt((FloatType) toneRampSeconds * fs));
+    updateToneStack(chain, calcToneStack(previousTone, oversampledRate.load()));
+
+    // reset after the tone stack is set, so that it starts on its target
+    resetChain(chain);
+    updateLatency(chain);
+}
+
+template <typename FloatType>
+void GptScreamerAudioProcessor::resetChain(DSPChain<FloatType>& chain)
+{
+    chain.oversampling.reset();
+    chain.lowLatencyOversampling.reset();
+    chain.firOversampling.reset();
+    chain.driveGain.reset();
+    chain.driveChain.reset();
+    chain.adaaClipper.reset();
+    chain.outputStage.reset();
+}
 
-double GptScreamerAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+template <typename FloatType>
+void GptScreamerAudioProcessor::updateLatency(DSPChain<FloatType>& chain)
+{
+    // the low-latency oversampler only has the (sub-sample) group delay of its filters,
+    // and the ADAA clipper adds one sample of delay at the oversampled rate
+    float latency = chain.oversampling.getLatencySamples();
+    if (oversamplingEngine == OversamplingEngine::LowLatency)
+        latency = chain.lowLatencyOversampling.getLatencySamples();
+    else if (oversamplingEngine == OversamplingEngine::PolyphaseFIR)
+        latency = (float) chain.firOversampling.getLatencySamples();
 
-int GptScreamerAudioProcessor::getNumPrograms() { return 1; }
+    if (useADAAClipper)
+        latency += 1.0f / (float) chain.oversampling.getOSFactor();
 
-int GptScreamerAudioProcessor::getCurrentProgram() { return 0; }
+    setLatencySamples(juce::roundToInt(latency));
 
-void GptScreamerAudioProcessor::setCurrentProgram (int index) {}
+    // the chain has rung out once the tail has made it through the oversampler
+    idleTailSamples = juce::roundToInt(idleTailSeconds * baseSampleRate) + getLatencySamples();
+}
 
-const juce::String GptScreamerAudioProcessor::getProgramName (int index) { return {}; }
+template <typename FloatType>
+bool GptScreamerAudioProcessor::updateIdleState(const juce::AudioBuffer<FloatType>& buffer, DSPChain<FloatType>& chain)
+{
+    const auto numSamples = buffer.getNumSamples();
+    numSamplesProcessed += (juce::uint64) numSamples;
 
-void GptScreamerAudioProcessor::changeProgramName (int index, const juce::String& newName) {}
+    bool inputIsSilent = true;
+    for (int ch = 0; ch < buffer.getNumChannels() && inputIsSilent; ++ch)
+        inputIsSilent = buffer.getMagnitude(ch, 0, numSamples) <= (FloatType) silenceThreshold;
+
+    if (! inputIsSilent)
+    {
+        // signal is back after being idle: start again from a clean state,
+        // with the drive and tone already on their targets
+        if (silentSamples >= idleTailSamples)
+            resetChain(chain);
+
+        silentSamples = 0;
+        return false;
+    }
+
+    // still ringing out, so keep processing
+    if (silentSamples < idleTailSamples)
+    {
+        silentSamples += numSamples;
+        return false;
+    }
+
+    numIdleSamples += (juce::uint64) numSamples;
+    return true;
+}
 
 //==============================================================================
-juce::AudioProcessorValueTreeState::ParameterLayout GptScreamerAudioProcessor::createParameterLayout()
+static std::vector<chowdsp::presets::Preset> getFactoryPresets()
 {
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-
-    // --- TONE Parameter (Range 0.0 to 1.0) ---
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("TONE", 1),         // Parameter ID and version
-        "Tone",                               // User-facing name
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), // Range: start, end, interval
-        0.5f                                  // Default value
-    ));
-
-    // --- DRIVE Parameter (Range 0 dB to 30 dB) ---
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("DRIVE", 1),        // Parameter ID and version
-        "Drive",                              // User-facing name
-        juce::NormalisableRange<float>(0.0f, 30.0f, 0.1f, 1.0f), // Range, interval, skew
-        0.0f                                  // Default value
-    ));
-
-    return layout;
+    // parameters that a preset doesn't mention are reset to their defaults
+    const auto preset = [] (const char* name, const char* category, nlohmann::json&& presetState)
+    {
+        return chowdsp::presets::Preset { name, "GptScreamer", std::move (presetState), category };
+    };
+
+    std::vector<chowdsp::presets::Preset> presets;
+    presets.push_back (preset ("Default", "Boost", { { "TONE", 0.5f }, { "DRIVE", 0.0f } }));
+    presets.push_back (preset ("Clean Boost", "Boost", { { "TONE", 0.6f }, { "DRIVE", 6.0f } }));
+    presets.push_back (preset ("Classic Screamer", "Drive", { { "TONE", 0.5f }, { "DRIVE", 15.0f } }));
+    presets.push_back (preset ("Dark Rhythm", "Drive", { { "TONE", 0.3f }, { "DRIVE", 18.0f }, { "CLIPPER", 1 } }));
+    presets.push_back (preset ("Vintage 808", "Drive", { { "TONE", 0.45f }, { "DRIVE", 12.0f }, { "CLIPPER", 2 } }));
+    presets.push_back (preset ("Singing Lead", "Lead", { { "TONE", 0.7f }, { "DRIVE", 24.0f }, { "CLIPPER", 1 } }));
+    presets.push_back (preset ("Saturated Lead", "Lead", { { "TONE", 0.8f }, { "DRIVE", 30.0f }, { "CLIPPER", 1 }, { "OUTPUT", 1 } }));
+    return presets;
 }
 
-void GptScreamerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+void GptScreamerAudioProcessor::setupPresets()
 {
-    // Create a spec for the oversampled audio
-    const float sampleRateMultiplier = 8.0f;
-    oversampledRate = sampleRate * sampleRateMultiplier; // 2^3
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = oversampledRate;
-    spec.maximumBlockSize = samplesPerBlock * sampleRateMultiplier;
-    spec.numChannels = 1; // Mono
-
-    // Prepare all our components with this spec
-    oversampling.initProcessing(samplesPerBlock);
-    inputHP.prepare(spec);
-    preClipLP.prepare(spec);
-    drive.prepare(spec);
-    clipper.prepare(spec);
-    preToneLP.prepare(spec);
-    outputHP.prepare(spec);
-    bassShelf.prepare(spec);
-    trebShelf.prepare(spec);
-    outputLimiter.prepare(spec);
-    outputLimiter.setThreshold (-0.3f); // dB
-    outputLimiter.setRelease (50.0f);
-    
-    // set initial static filter values
-    *inputHP.coefficients = *juce::dsp::IIR::Coefficients<float>::makeFirstOrderHighPass(oversampledRate, input_HP_Fc);
-    *preClipLP.coefficients = *juce::dsp::IIR::Coefficients<float>::makeFirstOrderLowPass(oversampledRate, pre_clip_LP_Fc);
-    *preToneLP.coefficients = *juce::dsp::IIR::Coefficients<float>::makeFirstOrderLowPass(oversampledRate, pre_tone_LP_Fc);
-    *outputHP.coefficients = *juce::dsp::IIR::Coefficients<float>::makeFirstOrderHighPass(oversampledRate, output_HP_Fc);
-
-    // set initial dynamic shelf values
-    const float rampDurationSeconds = 0.001f; // 1 millisecond
-    smoothedTone.reset (oversampledRate, rampDurationSeconds);
-    smoothedTone.setCurrentAndTargetValue (previousTone);
-    updateBassShelf(previousTone);
-    updateTrebShelf(previousTone);
-    
-    // Set the drive (60.0f is a gain of +35.5 dB, which is huge!)
-    // We set gain in decibels for a more natural knob feel
-    drive.setGainDecibels(50.0f);
-    
-    // prepare the buffer for parallel processing
-    trebBuffer.setSize (1, samplesPerBlock * sampleRateMultiplier, false, true, true);
-    bassBuffer.setSize (1, samplesPerBlock * sampleRateMultiplier, false, true, true);
+    // the oversampling and latency settings are about quality and monitoring
+    // rather than the sound, so loading a preset leaves them alone
+    auto& params = state.params;
+    presetManager = std::make_unique<chowdsp::presets::PresetManager>(
+        state, this, ".gptpreset",
+        std::vector<juce::RangedAudioParameter*> { params.lowLatency.get(), params.firOversampling.get(),
+                                                   params.osFactor.get(), params.osMode.get(),
+                                                   params.osRenderFactor.get(), params.osRenderMode.get(),
+                                                   params.osRenderLikeRealtime.get() });
+    presetManager->getPresetTree().treeInserter = &chowdsp::presets::PresetTreeInserters::categoryInserter;
+
+    // a preset's tone stack is worked out here on the message thread, before its
+    // parameters are applied, so that the audio thread finds it waiting in the
+    // pipeline when it sees the new TONE value
+    auto& saverLoader = presetManager->getSaveLoadHelper();
+    saverLoader.loadPresetState = [this, &saverLoader] (const nlohmann::json& presetState)
+    {
+        const auto& tone = *state.params.tone;
+        const auto toneID = tone.paramID.toStdString();
+        precomputeToneStack(presetState.contains(toneID) ? presetState[toneID].get<float>()
+                                                         : tone.convertFrom0to1(tone.getDefaultValue()));
+        saverLoader.loadPresetParameters(presetState);
+    };
+
+    presetManager->addPresets(getFactoryPresets());
+    presetManager->setDefaultPreset(chowdsp::presets::Preset { presetManager->getFactoryPresets().front() });
+    presetManager->setUserPresetPath(juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                         .getChildFile("GptScreamer/Presets"));
+    presetManager->loadDefaultPreset();
+
+    // the host's program list shows the factory presets
+    programAdaptor = std::make_unique<chowdsp::presets::frontend::PresetsProgramAdapter>(presetManager);
 }
 
+//==============================================================================
 inline float gTaper(float t) noexcept
 {
     return t * t * (3.0f - 2.0f * t); // smoothstep: 3t^2 - 2t^3
@@ -158,100 +274,188 @@ inline float map_inverse_extreme_taper(float t) noexcept
     }
 }
 
-void GptScreamerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void GptScreamerAudioProcessor::processAudioBlock (juce::AudioBuffer<float>& buffer)
 {
-    // thread-safe read of the slider values
-    float rawTone = apvts->getRawParameterValue("TONE")->load();
-    float currentTone = map_inverse_extreme_taper(rawTone); // doesn't seem to require smoothing!
+    processChain(buffer, floatChain);
+}
+
+void GptScreamerAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    // same as PluginBase::processBlock() for float buffers
+    juce::ScopedNoDenormals noDenormals;
+    state.getParameterListeners().callAudioThreadBroadcasters();
+
+    processChain(buffer, doubleChain);
+}
+
+template <typename FloatType>
+void GptScreamerAudioProcessor::processChain(juce::AudioBuffer<FloatType>& buffer, DSPChain<FloatType>& chain)
+{
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(loadMeasurer, buffer.getNumSamples());
     
-//    float newToneTarget = map_inverse_extreme_taper(rawTone);
-//    smoothedTone.setTargetValue(newToneTarget);
+    // oversampling factor (realtime or offline-render) and clipper engine
+    if (chain.oversampling.updateOSFactor())
+        oversamplingFactorChanged(chain);
+
+    const auto clipperIndex = state.params.clipper->getIndex();
+    const bool newUseADAAClipper = clipperIndex == 1;
+    const bool newUseWDFClipper = clipperIndex == 2;
+    if (newUseADAAClipper != useADAAClipper || newUseWDFClipper != useWDFClipper)
+    {
+        useADAAClipper = newUseADAAClipper;
+        useWDFClipper = newUseWDFClipper;
+        chain.adaaClipper.reset();
+        chain.driveChain.reset();
+        chain.driveChain.setADAAClipper(useADAAClipper ? &chain.adaaClipper : nullptr);
+        chain.driveChain.setWDFClipper(useWDFClipper);
+        updateLatency(chain);
+    }
+
+    // low latency wins if both are on, since it's for monitoring live
+    const auto newOversamplingEngine = state.params.lowLatency->get()      ? OversamplingEngine::LowLatency
+                                     : state.params.firOversampling->get() ? OversamplingEngine::PolyphaseFIR
+                                                                           : OversamplingEngine::Standard;
+    if (newOversamplingEngine != oversamplingEngine)
+    {
+        oversamplingEngine = newOversamplingEngine;
+        chain.oversampling.reset();
+        chain.lowLatencyOversampling.reset();
+        chain.firOversampling.reset();
+        updateLatency(chain);
+    }
+
+    // thread-safe read of the slider values
+    float rawTone = state.params.tone->getCurrentValue(); // smoothed per sample in the drive chain
 
-    if(currentTone != previousTone)
+    if(rawTone != previousTone)
     {
-        updateBassShelf(currentTone);
-        updateTrebShelf(currentTone);
-        previousTone = currentTone;
+        updateToneStack(chain, getToneStackForAudioThread(rawTone));
+        previousTone = rawTone;
     }
-    drive.setGainDecibels(apvts->getRawParameterValue("DRIVE")->load());
     
+    // nothing to do once a silent input has rung out (the settings above are
+    // still kept up to date, so that the reported latency stays right, and
+    // the tone stack is already on its target when the input comes back)
+    if (updateIdleState(buffer, chain))
+    {
+        buffer.clear();
+        return;
+    }
+    stageProfiler.addSamples(buffer.getNumSamples());
+
     // up-sample
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::AudioBlock<float> ovBlock;
-    ovBlock = oversampling.processSamplesUp(block);
-    
-    // create a processing context for the oversampled block
-    juce::dsp::ProcessContextReplacing<float> ovContext(ovBlock);
-
-    // run the DSP chain (in order)
-    inputHP.process(ovContext);
-    preClipLP.process(ovContext);
-    drive.process(ovContext);
-    clipper.process(ovContext);
-    preToneLP.process(ovContext);
-
-    juce::dsp::AudioBlock<float> bassBlock(bassBuffer);
-    bassBlock.copyFrom(ovBlock);
-    juce::dsp::ProcessContextReplacing<float> bassContext(bassBlock);
-    
-    juce::dsp::AudioBlock<float> trebBlock(trebBuffer);
-    trebBlock.copyFrom(ovBlock);
-    juce::dsp::ProcessContextReplacing<float> trebContext(trebBlock);
+    juce::dsp::AudioBlock<FloatType> block(buffer);
+    juce::dsp::AudioBlock<FloatType> ovBlock;
+    {
+        StageProfiler::Scope profile(&stageProfiler, StageProfiler::Upsample);
+        if (oversamplingEngine == OversamplingEngine::LowLatency)
+            ovBlock = chain.lowLatencyOversampling.processSamplesUp(block);
+        else if (oversamplingEngine == OversamplingEngine::PolyphaseFIR)
+            ovBlock = chain.firOversampling.processSamplesUp(block);
+        else
+            ovBlock = chain.oversampling.processSamplesUp(block);
+    }
     
-    // process tone-stack
-    bassShelf.process(bassContext);
-    trebShelf.process(trebContext);
+    // run the whole DSP chain (filters, drive, clipper, tone-stack) in one pass
+    {
+        const bool driveWasSmoothing = chain.driveGain.isSmoothing();
+        {
+            StageProfiler::Scope profile(&stageProfiler, StageProfiler::Drive);
+            chain.driveGain.process((int) ovBlock.getNumSamples());
+        }
 
-    // recombine
-    ovBlock.add(bassBlock.multiplyBy(currentBassBoostFactor * -1.0f));
-    ovBlock.add(trebBlock.multiplyBy(currentTrebBoostFactor));
+        // per-sample gains only while the drive is moving, so the WDF clipper can keep fixed coefficients otherwise
+        // (checked before the gains are processed as well as after, so the block that a ramp ends in always gets it)
+        if (driveWasSmoothing || chain.driveGain.isSmoothing())
+        {
+            chain.driveChain.process(ovBlock, chain.driveGain.getSmoothedBuffer());
+        }
+        else
+        {
+            chain.driveChain.setDriveGain(chain.driveGain.getCurrentValue());
+            chain.driveChain.process(ovBlock);
+        }
+    }
     
-    // process, limit and output
-    outputHP.process(ovContext);
-    outputLimiter.process(ovContext);
-    oversampling.processSamplesDown(block);
+    // down-sample, then limit (or clip) at the base rate
+    {
+        StageProfiler::Scope profile(&stageProfiler, StageProfiler::Downsample);
+        if (oversamplingEngine == OversamplingEngine::LowLatency)
+            chain.lowLatencyOversampling.processSamplesDown(block);
+        else if (oversamplingEngine == OversamplingEngine::PolyphaseFIR)
+            chain.firOversampling.processSamplesDown(block);
+        else
+            chain.oversampling.processSamplesDown(block);
+    }
+    {
+        StageProfiler::Scope profile(&stageProfiler, StageProfiler::Output);
+        chain.outputStage.setMode(state.params.output->getIndex() == 1 ? OutputStageMode::Clipper : OutputStageMode::Limiter);
+        chain.outputStage.process(block);
+    }
 }
 
-void GptScreamerAudioProcessor::updateBassShelf(float tone)
+template <typename FloatType>
+void GptScreamerAudioProcessor::updateToneStack(DSPChain<FloatType>& chain, const ToneStackCoefficients& coefs)
 {
-    float R_shunt_total_bass = (tone * R_tone_pot) + R_shunt;
-    float Fp_bass = 1 / (2 * M_PI * (R_bass + R_shunt_total_bass) * C_shunt);
-    
-    if (std::isinf(Fp_bass) || std::isnan(Fp_bass))
-        {
-            DBG("!!! NaN/INF DETECTED in Fp_bass !!!");
-            DBG("R_shunt_total_bass: " << R_shunt_total_bass);
-            
-            // Safety: Clamp to a known-safe value to prevent the crash
-            // and allow the plugin to continue running for better debugging.
-            Fp_bass = 20.0f; // Use a reasonable low frequency (e.g., 20 Hz)
-        }
-    
-    currentBassBoostFactor = 1.0f - (R_shunt_total_bass / (R_bass + R_shunt_total_bass));
-    DBG("Fp_bass: " << Fp_bass << " | currentBassBoostFactor " << currentBassBoostFactor);
-    
-    *bassShelf.coefficients = *juce::dsp::IIR::Coefficients<float>::makeFirstOrderHighPass(oversampledRate, Fp_bass);
+    // both branches are merged into a single second-order filter in the drive chain
+    chain.driveChain.setToneStack((FloatType) coefs.gBass, (FloatType) coefs.kBass, (FloatType) coefs.gTreb, (FloatType) coefs.kTreb);
 }
 
-void GptScreamerAudioProcessor::updateTrebShelf(float tone)
+GptScreamerAudioProcessor::ToneStackCoefficients GptScreamerAudioProcessor::getToneStackForAudioThread(float rawTone) noexcept
 {
-    float R_shunt_total_treb = ((1 - tone) * R_tone_pot) + R_shunt;
-    float Fp_treb = 1 / (2 * M_PI * R_shunt_total_treb * C_shunt);
-    
-    if (std::isinf(Fp_treb) || std::isnan(Fp_treb))
-        {
-            DBG("!!! NaN/INF DETECTED in Fp_treb !!!");
-            DBG("R_shunt_total_treb: " << R_shunt_total_treb);
+    // Use the coefficients precomputed for the latest preset load, if they haven't
+    // been used yet, and are for this rate and (to within rounding, since the value
+    // has been through the parameter since) this tone. Otherwise work them out here.
+    const auto fs = oversampledRate.load();
+    const auto* precomputed = toneStackPipeline.read();
+    if (precomputed != nullptr
+        && precomputed->generation != lastUsedToneStackGeneration
+        && precomputed->sampleRate == fs
+        && std::abs(precomputed->rawTone - rawTone) <= toneMatchTolerance)
+    {
+        lastUsedToneStackGeneration = precomputed->generation;
+        return *precomputed;
+    }
 
-            // Safety: Clamp to a known-safe value to prevent the crash.
-            // Use a reasonable high frequency (e.g., 20 kHz)
-            Fp_treb = 20000.0f;
-        }
+    return calcToneStack(rawTone, fs);
+}
+
+void GptScreamerAudioProcessor::precomputeToneStack(float rawTone)
+{
+    auto coefs = std::make_unique<ToneStackCoefficients>(calcToneStack(rawTone, oversampledRate.load()));
+    coefs->generation = ++toneStackGeneration;
+    toneStackPipeline.write(std::move(coefs));
+}
 
-    currentTrebBoostFactor = R_feed / R_shunt_total_treb;
-    DBG("Fp_treb: " << Fp_treb << " | currentTrebBoostFactor " << currentTrebBoostFactor);
+GptScreamerAudioProcessor::ToneStackCoefficients GptScreamerAudioProcessor::calcToneStack(float rawTone, float sampleRate) const noexcept
+{
+    const float tone = map_inverse_extreme_taper(rawTone);
 
-    *trebShelf.coefficients = *juce::dsp::IIR::Coefficients<float>::makeFirstOrderHighPass(oversampledRate, Fp_treb);
+    // bass branch: highpass into the bass shunt, subtracted from the signal
+    float R_shunt_total_bass = (tone * R_tone_pot) + R_shunt;
+    float Fp_bass = 1.0f / (juce::MathConstants<float>::twoPi * (R_bass + R_shunt_total_bass) * C_shunt);
+    
+    // Safety: this can run on the audio thread, so no logging here, just
+    // clamp to a known-safe value (20 Hz) if the maths ever goes wrong
+    if (! std::isfinite(Fp_bass))
+        Fp_bass = 20.0f;
+    
+    // treble branch: highpass into the feedback path, added to the signal
+    float R_shunt_total_treb = ((1 - tone) * R_tone_pot) + R_shunt;
+    float Fp_treb = 1.0f / (juce::MathConstants<float>::twoPi * R_shunt_total_treb * C_shunt);
+    
+    // Safety: same as the bass branch, but clamp to 20 kHz
+    if (! std::isfinite(Fp_treb))
+        Fp_treb = 20000.0f;
+
+    ToneStackCoefficients coefs;
+    coefs.rawTone = rawTone;
+    coefs.sampleRate = sampleRate;
+    coefs.gBass = prewarpedCutoff(Fp_bass, sampleRate);
+    coefs.kBass = 1.0f - (R_shunt_total_bass / (R_bass + R_shunt_total_bass));
+    coefs.gTreb = prewarpedCutoff(Fp_treb, sampleRate);
+    coefs.kTreb = R_feed / R_shunt_total_treb;
+    return coefs;
 }
 
 void GptScreamerAudioProcessor::releaseResources() {}
@@ -259,16 +463,15 @@ void GptScreamerAudioProcessor::releaseResources() {}
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool GptScreamerAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout from mono up to maxNumChannels is supported, the drive chain
+    // interleaves the channels into SIMD registers so that they cost about
+    // the same as a single one.
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    if (mainOutput.isDisabled() || mainOutput.size() > maxNumChannels)
         return false;
 
     // This checks if the input layout matches the output layout
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+    if (mainOutput != layouts.getMainInputChannelSet())
         return false;
 
     return true;
@@ -276,11 +479,6 @@ bool GptScreamerAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 #endif
 
 //==============================================================================
-bool GptScreamerAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
 juce::AudioProcessorEditor* GptScreamerAudioProcessor::createEditor()
 {
     return new GptScreamerAudioProcessorEditor (*this);
@@ -289,15 +487,31 @@ juce::AudioProcessorEditor* GptScreamerAudioProcessor::createEditor()
 //==============================================================================
 void GptScreamerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // compact binary state, rather than the JSON that PluginBase would write
+    BinaryState::write (state.params, state.getNonParameters(), destData);
 }
 
 void GptScreamerAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    // states from builds that saved JSON
+    if (! BinaryState::isBinaryState (data, (size_t) sizeInBytes))
+    {
+        PluginBase::setStateInformation (data, sizeInBytes);
+        return;
+    }
+
+    state.callOnMainThread (
+        [this, stateData = juce::MemoryBlock { data, (size_t) sizeInBytes }]
+        {
+            chowdsp::Version stateVersion;
+            if (! BinaryState::read (stateData, state.params, state.getNonParameters(), stateVersion))
+                return;
+
+            state.params.applyVersionStreaming (stateVersion);
+            if (state.getNonParameters().versionStreamingCallback != nullptr)
+                state.getNonParameters().versionStreamingCallback (stateVersion);
+            state.getParameterListeners().updateBroadcastersFromMessageThread();
+        });
 }
 
 //==============================================================================
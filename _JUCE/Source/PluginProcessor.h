@@ -10,11 +10,19 @@
 #include <juce_dsp/juce_dsp.h>
 #include <JuceHeader.h>
 #include <chowdsp_filters/LowerOrderFilters/chowdsp_FirstOrderFilters.h>
+#include "MultiChannelDriveChain.h"
+#include "ADAADiodeClipper.h"
+#include "OutputStage.h"
+#include "LowLatencyOversampling.h"
+#include "FIROversampling.h"
+#include "StageProfiler.h"
+#include "Params.h"
+#include "BinaryState.h"
 
 //==============================================================================
 /**
 */
-class GptScreamerAudioProcessor  : public juce::AudioProcessor
+class GptScreamerAudioProcessor  : public chowdsp::PluginBase<GptScreamerState>
 {
 public:
     //==============================================================================
@@ -29,73 +37,142 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
    #endif
 
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processAudioBlock (juce::AudioBuffer<float>&) override;
 
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
+    // hosts with a 64-bit mix engine get a double-precision chain, rather than
+    // a round-trip through float
+    using chowdsp::PluginBase<GptScreamerState>::processBlock;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
+    // how long the filters take to ring out once the input goes silent
+    double getTailLengthSeconds() const override { return (double) idleTailSeconds; }
 
     //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
+    juce::AudioProcessorEditor* createEditor() override;
 
     //==============================================================================
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
-    
-    //==============================================================================
-    void updateBassShelf(float tone);
-    void updateTrebShelf(float tone);
 
-    std::unique_ptr<juce::AudioProcessorValueTreeState> apvts;
+    //==============================================================================
+    /** Number of samples processBlock() has been called with since the processor was created. */
+    juce::uint64 getNumSamplesProcessed() const noexcept { return numSamplesProcessed; }
+    
+    /**
+        Number of those samples that were skipped, because the input had been
+        silent for long enough that the whole chain had rung out.
+    */
+    juce::uint64 getNumIdleSamples() const noexcept { return numIdleSamples; }
+    
+    /** Time spent in each stage, for the editor and the render tool (only counted in GPTSCREAMER_PROFILE_STAGES builds). */
+    const StageProfiler& getStageProfiler() const noexcept { return stageProfiler; }
+    
+    /** How much of the host's time budget each processBlock() call uses, for the editor's CPU meter. */
+    const juce::AudioProcessLoadMeasurer& getLoadMeasurer() const noexcept { return loadMeasurer; }
     
 private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GptScreamerAudioProcessor)
     
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    StageProfiler stageProfiler;
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+   #if GPTSCREAMER_PROFILE_STAGES
+    chowdsp::Logger profileLogger { "GptScreamer", "GptScreamer_profile" };
+   #endif
+    void setupPresets();
     
-    // oversampler 2^3
-    juce::dsp::Oversampling<float> oversampling { 1, 3, juce::dsp::Oversampling<float>::FilterType::filterHalfBandPolyphaseIIR, true };
-    float oversampledRate;
+    // everything that processes audio, for one sample type (only the chain for
+    // the processing precision the host has chosen is prepared)
+    template <typename FloatType>
+    struct DSPChain
+    {
+        DSPChain(GptScreamerAudioProcessor& processor, chowdsp::LookupTableCache& lutCache);
+        
+        // realtime and offline-render oversampling, selected by the "os_*" parameters
+        chowdsp::VariableOversampling<FloatType> oversampling;
+        
+        // used instead of `oversampling` (at the same factor) when LOW_LATENCY is on
+        LowLatencyOversampling<FloatType> lowLatencyOversampling;
+        
+        // used instead of `oversampling` (at the same factor) when FIR_OVERSAMPLING is on
+        // and LOW_LATENCY isn't
+        FIROversampling<FloatType> firOversampling;
+        
+        // drive gain, smoothed per sample at the oversampled rate
+        chowdsp::SmoothedBufferValue<FloatType, juce::ValueSmoothingTypes::Multiplicative> driveGain;
+        
+        // output limiter/clipper (base rate)
+        OutputStage<FloatType> outputStage;
+        
+        // the static filters, drive, clipper and tone stack, all run in a single pass
+        // (clipper defaults to DiodeClipper<ClipperAccuracy::High>)
+        MultiChannelDriveChain<FloatType> driveChain;
+        
+        // ADAA clipper engine, swapped into the drive chain when CLIPPER is set to "ADAA"
+        // (the "WDF" engine lives in the drive chain itself)
+        ADAADiodeClipper<FloatType> adaaClipper;
+    };
     
-    // limiter
-    juce::dsp::Limiter<float> outputLimiter;
+    template <typename FloatType>
+    void prepareChain(DSPChain<FloatType>& chain);
+    template <typename FloatType>
+    void processChain(juce::AudioBuffer<FloatType>& buffer, DSPChain<FloatType>& chain);
+    template <typename FloatType>
+    void oversamplingFactorChanged(DSPChain<FloatType>& chain);
+    template <typename FloatType>
+    void updateLatency(DSPChain<FloatType>& chain);
+    template <typename FloatType>
+    void resetChain(DSPChain<FloatType>& chain);
+    template <typename FloatType>
+    bool updateIdleState(const juce::AudioBuffer<FloatType>& buffer, DSPChain<FloatType>& chain);
     
-    // these are static filters which won't change
-    juce::dsp::IIR::Filter<float> inputHP;
-    juce::dsp::IIR::Filter<float> preClipLP;
-    juce::dsp::IIR::Filter<float> preToneLP;
-    juce::dsp::IIR::Filter<float> outputHP;
+    // tone-stack coefficients and boost factors for one TONE value, at one oversampled rate
+    struct ToneStackCoefficients
+    {
+        float rawTone = 0.5f; // raw, untapered TONE value
+        float sampleRate = 0.0f;
+        float gBass = 1.0f, kBass = 0.0f; // prewarped cutoff, boost factor
+        float gTreb = 1.0f, kTreb = 0.0f; // prewarped cutoff, boost factor (represents Av - 1)
+        juce::uint32 generation = 0; // which preset load these were precomputed for (0 if they weren't)
+    };
+    ToneStackCoefficients calcToneStack(float rawTone, float sampleRate) const noexcept;
+    ToneStackCoefficients getToneStackForAudioThread(float rawTone) noexcept;
+    void precomputeToneStack(float rawTone);
+    template <typename FloatType>
+    void updateToneStack(DSPChain<FloatType>& chain, const ToneStackCoefficients& coefs);
     
-    // dynamic shelving that will change depending on tone - internal smoothing
-//    chowdsp::ShelfFilter<float> bassShelf;
-    juce::dsp::IIR::Filter<float> bassShelf;
-    float currentBassBoostFactor = 0.0f;
+    // coefficients computed on the message thread when a preset is loaded, so that the
+    // audio thread can pick them up instead of computing them itself (only the audio
+    // thread reads from the pipeline, and it uses each preset load's entry at most once)
+    chowdsp::UIToAudioPipeline<ToneStackCoefficients> toneStackPipeline;
+    juce::uint32 toneStackGeneration = 0; // message thread
+    juce::uint32 lastUsedToneStackGeneration = 0; // audio thread
     
-
-//    chowdsp::ShelfFilter<float> trebShelf;
-    juce::dsp::IIR::Filter<float> trebShelf;
-    float currentTrebBoostFactor = 0.0f; // Represents (Av - 1)
+    static constexpr int maxOversamplingFactor = 16;
+    static constexpr int maxNumChannels = 8;
+    double baseSampleRate = 48000.0;
+    int maxBlockSize = 512;
+    int numChannels = 1;
+    std::atomic<float> oversampledRate { 48000.0f }; // also read by precomputeToneStack()
+    
+    // the ADAA lookup tables are shared by both chains (and every other instance)
+    chowdsp::SharedLookupTableCache lutCache;
+    DSPChain<float> floatChain { *this, lutCache.get() };
+    DSPChain<double> doubleChain { *this, lutCache.get() };
+    
+    bool useADAAClipper = false; // for whichever chain is in use
+    bool useWDFClipper = false;
     
-    // clipping components
-    juce::dsp::WaveShaper<float> clipper;
-    juce::dsp::Gain<float> drive; // has internal smoothing
+    // which oversampler the chain goes through
+    enum class OversamplingEngine { Standard, LowLatency, PolyphaseFIR };
+    OversamplingEngine oversamplingEngine = OversamplingEngine::Standard;
     
-    // buffer for the parallel processed treble boost
-    juce::AudioBuffer<float> bassBuffer;
-    juce::AudioBuffer<float> trebBuffer;
+    // idle state: once the input has been silent for idleTailSamples, the
+    // chain is skipped until it isn't
+    int silentSamples = 0;
+    int idleTailSamples = 0;
+    std::atomic<juce::uint64> numSamplesProcessed { 0 }, numIdleSamples { 0 };
     
     // const for algorithms
     const float input_HP_Fc = 723.4f;
@@ -108,6 +185,10 @@ private:
     const float R_shunt = 220.0f; // 220Ω
     const float C_shunt = 220e-9f; // 220nF
     
-    juce::SmoothedValue<float> smoothedTone { 0.5f }; // Initialize with default
+    const float toneRampSeconds = 0.01f; // 10 ms
+    const float toneMatchTolerance = 1.0e-4f; // well inside the TONE parameter's steps of 0.001
+    const float driveRampSeconds = 0.05f; // 50 ms
+    const float silenceThreshold = 1.0e-8f; // -160 dBFS
+    const float idleTailSeconds = 0.1f; // the 30 Hz output highpass rings down by 120 dB in ~75 ms
     float previousTone = 0.5f;
 };
@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    StageProfiler.h
+
+    Per-stage timing for GptScreamerAudioProcessor, shown in the editor and
+    reported by the offline render tool. Build with
+    GPTSCREAMER_PROFILE_STAGES=1 to turn it on; otherwise every profiling
+    scope is an empty object and compiles away.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/** Config: GPTSCREAMER_PROFILE_STAGES
+    Accumulates the time spent in each stage of the DSP chain, for the
+    editor and the render tool.
+*/
+#ifndef GPTSCREAMER_PROFILE_STAGES
+ #define GPTSCREAMER_PROFILE_STAGES 0
+#endif
+
+//==============================================================================
+/**
+    Lock-free per-stage time counters, written by the audio thread and read
+    by the UI (or by the render tool once it has finished rendering).
+
+    Only the audio thread ever adds to the counters, so they are updated
+    with a relaxed load and store rather than a locked read-modify-write.
+    Readers take a Snapshot and work with the difference between two of
+    them.
+
+    The counters are in std::chrono::steady_clock nanoseconds. The drive
+    chain opens a few scopes per 64-sample chunk, so on most systems the
+    clock reads add a couple of nanoseconds per sample to what is measured.
+*/
+class StageProfiler
+{
+public:
+    enum Stage
+    {
+        Upsample = 0,
+        Drive,      // input highpass, pre-clip lowpass, drive gain (and its smoothing)
+        Clipper,    // diode/ADAA clipper, or the whole WDF clipping stage
+        ToneStack,  // pre-tone lowpass, tone stack, output highpass
+        Downsample,
+        Output,     // output limiter/clipper
+        numStages,
+    };
+
+    static constexpr std::array<const char*, numStages> stageNames { "upsample", "drive", "clipper", "tone stack", "downsample", "output" };
+
+    static constexpr bool isEnabled = GPTSCREAMER_PROFILE_STAGES != 0;
+
+    /** Counters at one point in time. */
+    struct Snapshot
+    {
+        std::array<std::uint64_t, numStages> nanoseconds {};
+        std::uint64_t numSamples = 0; // at the base rate
+    };
+
+   #if GPTSCREAMER_PROFILE_STAGES
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot snapshot;
+        for (size_t i = 0; i < (size_t) numStages; ++i)
+            snapshot.nanoseconds[i] = nanoseconds[i].load (std::memory_order_relaxed);
+        snapshot.numSamples = numSamples.load (std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    /** Writes each stage's share of the time between two snapshots to the chowdsp logger. */
+    static void log (const Snapshot& from, const Snapshot& to)
+    {
+        std::uint64_t totalNanoseconds = 0;
+        for (size_t i = 0; i < (size_t) numStages; ++i)
+            totalNanoseconds += to.nanoseconds[i] - from.nanoseconds[i];
+
+        // the logger may already have gone with another instance
+        const auto numSamplesInRange = to.numSamples - from.numSamples;
+        if (totalNanoseconds == 0 || numSamplesInRange == 0 || chowdsp::get_global_logger() == nullptr)
+            return;
+
+        chowdsp::log ("Stage profile over {} samples ({:.1f} ns/sample):",
+                      numSamplesInRange, (double) totalNanoseconds / (double) numSamplesInRange);
+        for (size_t i = 0; i < (size_t) numStages; ++i)
+        {
+            const auto stageNanoseconds = (double) (to.nanoseconds[i] - from.nanoseconds[i]);
+            chowdsp::log ("  {:<12} {:5.1f}%  {:.1f} ns/sample", stageNames[i],
+                          100.0 * stageNanoseconds / (double) totalNanoseconds, stageNanoseconds / (double) numSamplesInRange);
+        }
+    }
+
+    /** Counts the base-rate samples that the stage times are spread over (audio thread only). */
+    void addSamples (int n) noexcept { add (numSamples, (std::uint64_t) n); }
+
+    /** Adds the lifetime of this object to a stage, if the profiler is non-null. */
+    class Scope
+    {
+    public:
+        Scope (StageProfiler* p, Stage s) noexcept : profiler (p), stage (s)
+        {
+            if (profiler != nullptr)
+                start = Clock::now();
+        }
+
+        ~Scope() noexcept
+        {
+            if (profiler != nullptr)
+                add (profiler->nanoseconds[(size_t) stage],
+                     (std::uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (Clock::now() - start).count());
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        StageProfiler* profiler;
+        Stage stage;
+        Clock::time_point start {};
+    };
+
+   #else
+    Snapshot getSnapshot() const noexcept { return {}; }
+    static void log (const Snapshot&, const Snapshot&) {}
+    void addSamples (int) noexcept {}
+
+    class Scope
+    {
+    public:
+        Scope (StageProfiler*, Stage) noexcept {}
+    };
+   #endif
+
+private:
+   #if GPTSCREAMER_PROFILE_STAGES
+    static void add (std::atomic<std::uint64_t>& counter, std::uint64_t n) noexcept
+    {
+        counter.store (counter.load (std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, numStages> nanoseconds {};
+    std::atomic<std::uint64_t> numSamples { 0 };
+   #endif
+};
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+    WDFDiodeClipper.h
+
+    Wave digital filter model of the Tube Screamer's op-amp diode clipper,
+    with the diode pair solved explicitly through the Wright omega function
+    (no Newton-Raphson iterations).
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <chowdsp_math/chowdsp_math.h>
+
+//==============================================================================
+/**
+    Approximations of the Wright omega function, w(x) = W0(e^x), from
+    S. D'Angelo et al., "Fast Approximation of the Lambert W Function for
+    Virtual Analog Modelling" (DAFx 2019).
+
+    Written for scalars or xsimd batches.
+*/
+namespace WrightOmega
+{
+    /** Piecewise approximation: 0, then a cubic, then x - log(x). */
+    template <typename T>
+    inline T omega3 (T x) noexcept
+    {
+        using NumericType = chowdsp::SampleTypeHelpers::NumericType<T>;
+        constexpr auto x1 = (NumericType) -3.341459552768620;
+        constexpr auto x2 = (NumericType) 8.0;
+        constexpr auto a = (NumericType) -1.314293149877800e-3;
+        constexpr auto b = (NumericType) 4.775931364975583e-2;
+        constexpr auto c = (NumericType) 3.631952663804445e-1;
+        constexpr auto d = (NumericType) 6.313183464296682e-1;
+
+        const auto cubic = d + x * (c + x * (b + x * a));
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (x < x1)
+                return (T) 0;
+            if (x < x2)
+                return cubic;
+            return x - chowdsp::LogApprox::log<T> (x);
+        }
+        else
+        {
+            // log of x2 or above only, so the unused lanes can't produce NaNs
+            const auto tail = x - chowdsp::LogApprox::log<T> (xsimd::max (x, T (x2)));
+            return xsimd::select (x < x1, T ((NumericType) 0), xsimd::select (x < x2, cubic, tail));
+        }
+    }
+
+    /** omega3() refined with one Newton-Raphson step. */
+    template <typename T>
+    inline T omega4 (T x) noexcept
+    {
+        using NumericType = chowdsp::SampleTypeHelpers::NumericType<T>;
+
+        const auto y = omega3 (x);
+        return y - (y - chowdsp::PowApprox::exp<T> (x - y)) / (y + (NumericType) 1);
+    }
+} // namespace WrightOmega
+
+//==============================================================================
+/**
+    The clipping stage of a TS808. The op-amp holds its inverting input at
+    the input voltage, so the current through R4 (4.7k) and C3 (47 nF) to
+    ground is pushed through the feedback network: Rf (51k plus the 500k
+    drive pot) in parallel with Cf (51 pF) and a pair of 1N914 diodes. The
+    output is the input plus the voltage across that network.
+
+    That R4/C3 current is the input voltage through a first-order highpass
+    at 1 / (2 pi R4 C3) = 720 Hz (the drive chain's input highpass),
+    divided by R4, so processSample() takes both the input and the
+    highpassed input. The feedback network is then a WDF, with the current
+    source and Rf as a resistive current source:
+
+                  diode pair (root)
+                         |
+                 parallel adaptor
+                   /           \
+        i = hp(vin) / R4, Rf    Cf
+
+    The diode pair is solved with the explicit wave-domain expression from
+    K. J. Werner et al., "An Improved and Generalized Diode Clipper Model
+    for Wave Digital Filters" (AES 2015):
+
+        b = a - 2 Vt sgn(a) (w(log(R Is / Vt) + |a| / Vt) - w(log(R Is / Vt) - |a| / Vt))
+
+    with the Wright omega function w (see WrightOmega::omega4()) in place of
+    the Lambert W function.
+
+    The drive pot is set from the drive gain, which sweeps it from 0 to its
+    full travel as the gain goes from 1 to maxDriveGain (the top of the DRIVE
+    range), giving a stage gain of 12 to 118 (21.5 to 41.4 dB) at mid
+    frequencies.
+
+    The coefficients are scalar, SampleType may be an xsimd::batch. The
+    capacitor's state is kept by the caller, one per channel.
+
+    Setting the drive pot costs a divide and a std::log(), so rather than
+    calling setDriveGain() every sample while the drive moves, callers can
+    get the coefficients at either end of a stretch of samples with
+    getCoefficients(), and ramp between them (see DriveChain).
+*/
+template <typename SampleType>
+class WDFDiodeClipper
+{
+public:
+    using NumericType = chowdsp::SampleTypeHelpers::NumericType<SampleType>;
+
+    static constexpr double R4 = 4.7e3;
+    static constexpr double C3 = 47.0e-9;
+    static constexpr double R6 = 51.0e3;
+    static constexpr double RDrive = 500.0e3;
+    static constexpr double Cf = 51.0e-12;
+    static constexpr double Is = 2.52e-9; // 1N914 saturation current
+    static constexpr double Vt = 0.02585 * 1.752; // thermal voltage times ideality factor
+    static constexpr double maxDriveGain = 31.622776601683793; // +30 dB
+
+    /** The coefficients that depend on the drive pot (and the sample rate). */
+    struct Coefficients
+    {
+        NumericType sourceGain {}, alpha {}, logRIsOverVt {};
+    };
+
+    WDFDiodeClipper() { calcCoefficients(); }
+
+    //==============================================================================
+    /** Sets the sample rate the clipper runs at (i.e. the oversampled rate). */
+    void prepare (NumericType sampleRate) noexcept
+    {
+        capacitorR = (NumericType) (1.0 / (2.0 * (double) sampleRate * Cf));
+        calcCoefficients();
+    }
+
+    /** Sets the drive pot from a drive gain of 1 to maxDriveGain, only recalculating when it changes. */
+    void setDriveGain (NumericType newGain) noexcept
+    {
+        if (newGain == driveGain)
+            return;
+
+        driveGain = newGain;
+        calcCoefficients();
+    }
+
+    /** Returns the current coefficients. */
+    const Coefficients& getCoefficients() const noexcept { return coefs; }
+
+    /** Returns the coefficients for a drive gain, without changing the clipper's own. */
+    Coefficients getCoefficients (NumericType gain) const noexcept
+    {
+        const auto potPosition = std::clamp (((double) gain - 1.0) / (maxDriveGain - 1.0), 0.0, 1.0);
+        const auto Rf = R6 + RDrive * potPosition;
+        const auto Rc = (double) capacitorR;
+        const auto Rp = Rf * Rc / (Rf + Rc); // parallel adaptor's port resistance
+
+        Coefficients c;
+        c.sourceGain = (NumericType) (Rf / R4); // the current source's wave, i Rf
+        c.alpha = (NumericType) (Rp / Rf);
+        c.logRIsOverVt = (NumericType) std::log (Rp * Is / Vt);
+        jassert (c.logRIsOverVt < (NumericType) -3.341459552768620);
+        return c;
+    }
+
+    //==============================================================================
+    /**
+        Returns the output voltage for an input voltage and the same input
+        through the R4/C3 highpass. `capacitorState` holds the wave stored in
+        Cf, which should start at 0.
+    */
+    inline SampleType processSample (SampleType vin, SampleType vinHighPassed, SampleType& capacitorState) const noexcept
+    {
+        return processSample (vin, vinHighPassed, capacitorState, coefs);
+    }
+
+    /** Same as above, with the given coefficients rather than the clipper's own. */
+    static inline SampleType processSample (SampleType vin, SampleType vinHighPassed, SampleType& capacitorState, const Coefficients& c) noexcept
+    {
+        // waves reflected from the current source and the capacitor, and up out of the adaptor
+        const auto bSource = vinHighPassed * c.sourceGain;
+        const auto bCap = capacitorState;
+        const auto bUp = bCap + c.alpha * (bSource - bCap);
+
+        // root: the diode pair reflects the wave back down, and v = (a + b) / 2 across every port
+        const auto aUp = diodePair (bUp, c.logRIsOverVt);
+        capacitorState = aUp + bUp - bCap;
+
+        return vin + (NumericType) 0.5 * (aUp + bUp);
+    }
+
+private:
+    static inline SampleType diodePair (SampleType a, NumericType logRIsOverVt) noexcept
+    {
+        CHOWDSP_USING_XSIMD_STD (abs);
+        CHOWDSP_USING_XSIMD_STD (copysign);
+
+        // R is at most R6 + RDrive, which keeps log(R Is / Vt) below omega3's
+        // first breakpoint, so the second omega4() always comes down to exp()
+        const auto aOverVt = abs (a) * (NumericType) (1.0 / Vt);
+        const auto delta = WrightOmega::omega4 (logRIsOverVt + aOverVt) - chowdsp::PowApprox::exp<SampleType> (logRIsOverVt - aOverVt);
+
+        return a - copysign (delta * (NumericType) (2.0 * Vt), a);
+    }
+
+    void calcCoefficients() noexcept { coefs = getCoefficients (driveGain); }
+
+    NumericType capacitorR = (NumericType) (1.0 / (2.0 * 48000.0 * Cf));
+    NumericType driveGain = (NumericType) 1;
+
+    Coefficients coefs;
+};
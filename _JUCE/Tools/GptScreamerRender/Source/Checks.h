@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+    Checks.h
+
+    Accuracy checks for GptScreamerRender --check: each DSP kernel against
+    its reference implementation, on scalars and xsimd batches.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <iostream>
+
+#include "../../../Source/DiodeClipper.h"
+#include "../../../Source/WDFDiodeClipper.h"
+
+namespace Checks
+{
+/** Prints one check's result, and returns whether it passed. */
+inline bool report (const juce::String& name, double error, double tolerance)
+{
+    const auto passed = error <= tolerance;
+    std::cout << "  " << name.paddedRight (' ', 44) << "max error " << juce::String (error, 8).paddedRight (' ', 12)
+              << "(tolerance " << juce::String (tolerance) << ")  " << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+//==============================================================================
+/**
+    Returns the largest absolute difference between a clipper tier and
+    DiodeClipper<>::reference() over [-4, 4], either sample by sample, or
+    through process(), which runs full xsimd batches with a scalar tail.
+*/
+template <ClipperAccuracy accuracy, typename T>
+double diodeClipperError (bool useBatches)
+{
+    constexpr int numSamples = 8001; // not a multiple of the batch size, so process() also runs its scalar tail
+    std::vector<T> x ((size_t) numSamples), y ((size_t) numSamples);
+    for (int n = 0; n < numSamples; ++n)
+        x[(size_t) n] = (T) (-4.0 + 8.0 * (double) n / (double) (numSamples - 1));
+
+    if (useBatches)
+    {
+        y = x;
+        DiodeClipper<accuracy>::process (y.data(), numSamples);
+    }
+    else
+    {
+        for (size_t n = 0; n < x.size(); ++n)
+            y[n] = DiodeClipper<accuracy>::processSample (x[n]);
+    }
+
+    double maxError = 0.0;
+    for (size_t n = 0; n < x.size(); ++n)
+        maxError = juce::jmax (maxError, std::abs ((double) y[n] - (double) DiodeClipper<>::reference ((float) x[n])));
+
+    return maxError;
+}
+
+template <ClipperAccuracy accuracy>
+bool checkDiodeClipperTier (const char* tierName, double tolerance)
+{
+    auto passed = true;
+    passed &= report (juce::String (tierName) + ", float", diodeClipperError<accuracy, float> (false), tolerance);
+    passed &= report (juce::String (tierName) + ", double", diodeClipperError<accuracy, double> (false), tolerance);
+    passed &= report (juce::String (tierName) + ", float batches", diodeClipperError<accuracy, float> (true), tolerance);
+    passed &= report (juce::String (tierName) + ", double batches", diodeClipperError<accuracy, double> (true), tolerance);
+    return passed;
+}
+
+/** Checks every ClipperAccuracy tier against the reference clipper, within its stated error. */
+inline bool checkDiodeClipper()
+{
+    std::cout << "DiodeClipper vs reference() on [-4, 4]:\n";
+
+    auto passed = true;
+    passed &= checkDiodeClipperTier<ClipperAccuracy::Exact> ("Exact", 1.0e-6);
+    passed &= checkDiodeClipperTier<ClipperAccuracy::High> ("High", 6.0e-5); // 5.4e-5
+    passed &= checkDiodeClipperTier<ClipperAccuracy::Medium> ("Medium", 3.0e-4); // 2.5e-4
+    passed &= checkDiodeClipperTier<ClipperAccuracy::Low> ("Low", 6.0e-3); // 5.4e-3
+    return passed;
+}
+
+//==============================================================================
+/**
+    The same discretised circuit as WDFDiodeClipper (Cf through the
+    bilinear transform), solved for the voltage across the feedback network
+    with Newton-Raphson in the Kirchhoff domain, in double precision:
+
+        hp(vin) / R4 = v / Rf + iCf + 2 Is sinh(v / Vt)
+*/
+struct NewtonDiodeClipper
+{
+    using WDF = WDFDiodeClipper<double>;
+
+    NewtonDiodeClipper (double sampleRate, double driveGain)
+        : Rf (WDF::R6 + WDF::RDrive * juce::jlimit (0.0, 1.0, (driveGain - 1.0) / (WDF::maxDriveGain - 1.0))),
+          Rc (1.0 / (2.0 * sampleRate * WDF::Cf))
+    {
+    }
+
+    double processSample (double vin, double vinHighPassed)
+    {
+        // the capacitor's companion model: iCf = v / Rc - iHistory
+        const auto iHistory = vPrev / Rc + iCapPrev;
+        const auto iSource = vinHighPassed / WDF::R4;
+
+        auto v = vPrev;
+        for (int i = 0; i < 100; ++i)
+        {
+            const auto f = v / Rf + v / Rc - iHistory + 2.0 * WDF::Is * std::sinh (v / WDF::Vt) - iSource;
+            const auto df = 1.0 / Rf + 1.0 / Rc + 2.0 * WDF::Is / WDF::Vt * std::cosh (v / WDF::Vt);
+            const auto step = f / df;
+            v -= step;
+            if (std::abs (step) < 1.0e-12)
+                break;
+        }
+
+        iCapPrev = v / Rc - iHistory;
+        vPrev = v;
+        return vin + v;
+    }
+
+    const double Rf, Rc;
+    double vPrev = 0.0, iCapPrev = 0.0;
+};
+
+/**
+    Returns the largest absolute difference between WDFDiodeClipper and
+    NewtonDiodeClipper, for 20 ms of a 300 Hz sine. With xsimd batches, each
+    lane gets a different level, from `level` / numLanes up to `level`.
+*/
+template <typename T>
+double wdfClipperError (double sampleRate, double driveGain, double level)
+{
+    using NumericType = chowdsp::SampleTypeHelpers::NumericType<T>;
+    constexpr auto numLanes = (int) sizeof (T) / (int) sizeof (NumericType);
+
+    WDFDiodeClipper<T> wdf;
+    wdf.prepare ((NumericType) sampleRate);
+    wdf.setDriveGain ((NumericType) driveGain);
+
+    std::vector<NumericType> laneLevels;
+    std::vector<NumericType> vouts (numLanes);
+    std::vector<NewtonDiodeClipper> references;
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        laneLevels.push_back ((NumericType) (level * (lane + 1) / numLanes));
+        references.emplace_back (sampleRate, driveGain);
+    }
+
+    T capacitorState {};
+    double maxError = 0.0;
+    for (int n = 0; n < (int) (0.02 * sampleRate); ++n)
+    {
+        const auto sine = std::sin (juce::MathConstants<double>::twoPi * 300.0 * (double) n / sampleRate);
+
+        T vin;
+        if constexpr (std::is_floating_point_v<T>)
+            vin = (T) (sine * laneLevels[0]);
+        else
+            vin = T::load_unaligned (laneLevels.data()) * (NumericType) sine;
+
+        // the current is driven straight from the input, the highpass in front is the same in both
+        const auto vout = wdf.processSample (vin, vin, capacitorState);
+
+        if constexpr (std::is_floating_point_v<T>)
+            vouts[0] = vout;
+        else
+            vout.store_unaligned (vouts.data());
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto vinLane = sine * (double) laneLevels[(size_t) lane];
+            const auto expected = references[(size_t) lane].processSample (vinLane, vinLane);
+            maxError = juce::jmax (maxError, std::abs ((double) vouts[(size_t) lane] - expected));
+        }
+    }
+
+    return maxError;
+}
+
+/**
+    Checks the WDF clipper against a Newton-Raphson solve of the same
+    circuit, at the bottom, middle and top of the drive range. The error is
+    mostly omega4()'s own.
+*/
+inline bool checkWDFClipper()
+{
+    constexpr double sampleRate = 192000.0; // 48 kHz, 4x oversampled
+    constexpr double tolerance = 3.0e-3; // 2.4e-3 at the top of the drive range
+    std::cout << "WDFDiodeClipper vs Newton-Raphson, 300 Hz at " << juce::String (sampleRate) << " Hz (volts):\n";
+
+    auto passed = true;
+    for (const auto driveGain : { 1.0, 5.6, WDFDiodeClipper<double>::maxDriveGain })
+    {
+        for (const auto level : { 0.01, 0.5 })
+        {
+            const auto name = "drive " + juce::String (driveGain, 1) + ", level " + juce::String (level);
+            passed &= report (name + ", float", wdfClipperError<float> (sampleRate, driveGain, level), tolerance);
+            passed &= report (name + ", double", wdfClipperError<double> (sampleRate, driveGain, level), tolerance);
+            passed &= report (name + ", float batch", wdfClipperError<xsimd::batch<float>> (sampleRate, driveGain, level), tolerance);
+            passed &= report (name + ", double batch", wdfClipperError<xsimd::batch<double>> (sampleRate, driveGain, level), tolerance);
+        }
+    }
+
+    return passed;
+}
+
+//==============================================================================
+/** Runs every check, and returns whether they all passed. */
+inline bool runAll()
+{
+    auto passed = true;
+    passed &= checkDiodeClipper();
+    passed &= checkWDFClipper();
+    return passed;
+}
+} // namespace Checks
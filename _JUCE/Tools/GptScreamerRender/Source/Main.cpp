@@ -0,0 +1,375 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    GptScreamerRender: runs GptScreamerAudioProcessor without a host, so
+    that DSP changes can be benchmarked on CI machines, and re-amp stems
+    can be batch-processed.
+
+    The Builds/ and JuceLibraryCode/ folders are not checked in, generate
+    them with:
+
+        Projucer --resave GptScreamerRender.jucer
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include "../../../Source/PluginProcessor.h"
+#include "Checks.h"
+
+static_assert (StageProfiler::isEnabled, "the render tool reports the time spent in each stage, so it needs GPTSCREAMER_PROFILE_STAGES=1");
+
+namespace
+{
+const char* const usage = R"(GptScreamerRender: renders audio through the GptScreamer DSP chain.
+
+Usage:
+  GptScreamerRender [options]
+
+Options:
+  -i <file>, --input=<file>   Input audio file. Without one, a log sine sweep is rendered.
+  -o <file>, --output=<file>  Output WAV file (24-bit). Without one, nothing is written.
+  --block=<samples>           Block size (default 512).
+  --rate=<Hz>                 Sample rate. The input is resampled if it differs
+                              (default: the input's rate, or 48000).
+  --channels=<n>              Number of channels for the generated sweep (default 2).
+  --length=<seconds>          Length of the generated sweep (default 10).
+  --silence=<seconds>         Appends digital silence to the input, to measure the
+                              idle bypass (default 0).
+  --set <PARAM>=<value>       Sets a parameter, in its own units (e.g. DRIVE=20,
+                              CLIPPER=1, os_render_factor=2). Can be repeated.
+  --automate <PARAM>=<t>:<v>,<t>:<v>,...
+                              Automates a parameter with a piecewise-linear curve
+                              (t in seconds, v in the parameter's units), updated
+                              at the start of each block. Can be repeated.
+  --repeat=<n>                Renders n times, and reports the fastest run (default 1).
+  --realtime                  Renders with the realtime oversampling settings,
+                              rather than the offline-render ones.
+  --double                    Renders through the double-precision processing path.
+  --check                     Checks the DSP kernels against their reference
+                              implementations, instead of rendering. Exits with 1
+                              if any of them is outside its tolerance.
+  -h, --help                  Shows this message.
+)";
+
+//==============================================================================
+/** A piecewise-linear automation curve for one parameter. */
+struct Automation
+{
+    juce::RangedAudioParameter* param = nullptr;
+    std::vector<std::pair<double, float>> points; // (seconds, value), sorted by time
+
+    float getValueAt (double time) const
+    {
+        if (time <= points.front().first)
+            return points.front().second;
+
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            const auto& [t1, v1] = points[i];
+            if (time < t1)
+            {
+                const auto& [t0, v0] = points[i - 1];
+                return v0 + (v1 - v0) * (float) ((time - t0) / (t1 - t0));
+            }
+        }
+
+        return points.back().second;
+    }
+};
+
+[[noreturn]] void fail (const juce::String& message)
+{
+    std::cerr << "Error: " << message << std::endl;
+    std::exit (1);
+}
+
+juce::RangedAudioParameter& findParameter (GptScreamerAudioProcessor& processor, const juce::String& paramID)
+{
+    for (auto* p : processor.getParameters())
+        if (auto* param = dynamic_cast<juce::RangedAudioParameter*> (p); param != nullptr && param->getParameterID() == paramID)
+            return *param;
+
+    fail ("unknown parameter \"" + paramID + "\"");
+}
+
+void setParameter (juce::RangedAudioParameter& param, float value)
+{
+    param.setValueNotifyingHost (param.convertTo0to1 (value));
+}
+
+juce::AudioBuffer<float> makeSweep (int numChannels, double sampleRate, double lengthSeconds)
+{
+    // log sine sweep, 20 Hz to 10 kHz at -12 dBFS
+    const auto numSamples = (int) (lengthSeconds * sampleRate);
+    const auto f0 = 20.0, f1 = 10000.0;
+    const auto L = lengthSeconds / std::log (f1 / f0);
+
+    juce::AudioBuffer<float> sweep (numChannels, numSamples);
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const auto t = (double) n / sampleRate;
+        const auto phase = juce::MathConstants<double>::twoPi * f0 * L * (std::exp (t / L) - 1.0);
+        const auto x = 0.25f * (float) std::sin (phase);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            sweep.setSample (ch, n, x);
+    }
+
+    return sweep;
+}
+
+juce::AudioBuffer<float> readInput (const juce::File& file, double& sampleRate)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (file));
+    if (reader == nullptr)
+        fail ("could not read \"" + file.getFullPathName() + "\"");
+
+    juce::AudioBuffer<float> input ((int) reader->numChannels, (int) reader->lengthInSamples);
+    reader->read (&input, 0, input.getNumSamples(), 0, true, true);
+
+    const auto fileRate = reader->sampleRate;
+    if (sampleRate <= 0.0 || sampleRate == fileRate)
+    {
+        sampleRate = fileRate;
+        return input;
+    }
+
+    // resample to the requested rate
+    const auto ratio = fileRate / sampleRate;
+    juce::AudioBuffer<float> resampled (input.getNumChannels(), (int) ((double) input.getNumSamples() / ratio));
+    for (int ch = 0; ch < input.getNumChannels(); ++ch)
+    {
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process (ratio, input.getReadPointer (ch), resampled.getWritePointer (ch), resampled.getNumSamples(),
+                              input.getNumSamples(), 0);
+    }
+
+    return resampled;
+}
+
+void writeOutput (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    file.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream (file.createOutputStream());
+    if (stream == nullptr)
+        fail ("could not write \"" + file.getFullPathName() + "\"");
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (stream.get(), sampleRate, (unsigned int) buffer.getNumChannels(), 24, {}, 0));
+    if (writer == nullptr)
+        fail ("could not write \"" + file.getFullPathName() + "\"");
+
+    stream.release(); // the writer owns it now
+    writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+}
+
+/**
+    Renders the input through the processor in blocks, numRepeats times, and
+    returns the time taken by the fastest run. The output of the last run is
+    left in `output`.
+*/
+template <typename FloatType>
+double render (GptScreamerAudioProcessor& processor, const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output,
+               std::vector<Automation>& automations, double sampleRate, int blockSize, int numRepeats)
+{
+    const auto numChannels = input.getNumChannels();
+    const auto numSamples = input.getNumSamples();
+
+    juce::AudioBuffer<FloatType> buffer (numChannels, numSamples);
+    juce::MidiBuffer midi;
+    double fastestRun = std::numeric_limits<double>::max();
+
+    for (int repeat = 0; repeat < numRepeats; ++repeat)
+    {
+        buffer.makeCopyOf (input, true);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        double runSeconds = 0.0;
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            for (auto& automation : automations)
+                setParameter (*automation.param, automation.getValueAt ((double) start / sampleRate));
+
+            juce::AudioBuffer<FloatType> block (buffer.getArrayOfWritePointers(), numChannels, start, juce::jmin (blockSize, numSamples - start));
+
+            const auto blockStart = std::chrono::steady_clock::now();
+            processor.processBlock (block, midi);
+            runSeconds += std::chrono::duration<double> (std::chrono::steady_clock::now() - blockStart).count();
+        }
+
+        processor.releaseResources();
+        fastestRun = juce::jmin (fastestRun, runSeconds);
+    }
+
+    output.makeCopyOf (buffer, true);
+    return fastestRun;
+}
+
+juce::String argumentValue (const juce::ArgumentList& args, const juce::String& option)
+{
+    const auto value = args.getValueForOption (option);
+    if (value.isEmpty())
+        fail (option.fromLastOccurrenceOf ("|", false, false) + " needs a value");
+    return value;
+}
+
+std::pair<juce::String, juce::String> splitAssignment (const juce::String& assignment)
+{
+    if (! assignment.contains ("="))
+        fail ("expected <PARAM>=<value>, got \"" + assignment + "\"");
+    return { assignment.upToFirstOccurrenceOf ("=", false, false), assignment.fromFirstOccurrenceOf ("=", false, false) };
+}
+} // namespace
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // the parameters need a message manager
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("-h|--help"))
+    {
+        std::cout << usage;
+        return 0;
+    }
+
+    if (args.containsOption ("--check"))
+        return Checks::runAll() ? 0 : 1;
+
+    const auto blockSize = args.containsOption ("--block") ? argumentValue (args, "--block").getIntValue() : 512;
+    const auto numRepeats = args.containsOption ("--repeat") ? argumentValue (args, "--repeat").getIntValue() : 1;
+    auto sampleRate = args.containsOption ("--rate") ? argumentValue (args, "--rate").getDoubleValue() : 0.0;
+
+    if (blockSize <= 0 || numRepeats <= 0 || sampleRate < 0.0)
+        fail ("--block, --repeat and --rate must be positive");
+
+    // input
+    juce::AudioBuffer<float> input;
+    if (args.containsOption ("-i|--input"))
+    {
+        input = readInput (args.getExistingFileForOption ("-i|--input"), sampleRate);
+    }
+    else
+    {
+        const auto numChannels = args.containsOption ("--channels") ? argumentValue (args, "--channels").getIntValue() : 2;
+        const auto length = args.containsOption ("--length") ? argumentValue (args, "--length").getDoubleValue() : 10.0;
+        if (numChannels <= 0 || length <= 0.0)
+            fail ("--channels and --length must be positive");
+
+        if (sampleRate <= 0.0)
+            sampleRate = 48000.0;
+        input = makeSweep (numChannels, sampleRate, length);
+    }
+
+    if (args.containsOption ("--silence"))
+    {
+        const auto silenceSeconds = argumentValue (args, "--silence").getDoubleValue();
+        if (silenceSeconds < 0.0)
+            fail ("--silence must not be negative");
+
+        const auto numInputSamples = input.getNumSamples();
+        input.setSize (input.getNumChannels(), numInputSamples + juce::roundToInt (silenceSeconds * sampleRate), true, true);
+    }
+
+    const auto numChannels = input.getNumChannels();
+    const auto numSamples = input.getNumSamples();
+
+    // processor
+    GptScreamerAudioProcessor processor;
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add (juce::AudioChannelSet::canonicalChannelSet (numChannels));
+    layout.outputBuses.add (juce::AudioChannelSet::canonicalChannelSet (numChannels));
+    if (! processor.setBusesLayout (layout))
+        fail ("GptScreamer does not support " + juce::String (numChannels) + " channels");
+
+    processor.setNonRealtime (! args.containsOption ("--realtime"));
+
+    const auto useDouble = args.containsOption ("--double");
+    processor.setProcessingPrecision (useDouble ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+
+    // parameters
+    std::vector<Automation> automations;
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto isSet = args[i] == "--set";
+        if ((! isSet && args[i] != "--automate") || i + 1 >= args.size())
+            continue;
+
+        const auto [paramID, value] = splitAssignment (args[++i].text);
+        auto& param = findParameter (processor, paramID);
+
+        if (isSet)
+        {
+            setParameter (param, value.getFloatValue());
+            continue;
+        }
+
+        Automation automation { &param, {} };
+        for (const auto& point : juce::StringArray::fromTokens (value, ",", {}))
+            automation.points.emplace_back (point.upToFirstOccurrenceOf (":", false, false).getDoubleValue(),
+                                            point.fromFirstOccurrenceOf (":", false, false).getFloatValue());
+
+        if (automation.points.empty())
+            fail ("no automation points for \"" + paramID + "\"");
+
+        std::stable_sort (automation.points.begin(), automation.points.end(), [] (auto& a, auto& b) { return a.first < b.first; });
+        automations.push_back (std::move (automation));
+    }
+
+    // render (this build has GPTSCREAMER_PROFILE_STAGES on, so the processor times each stage)
+    const auto profileBefore = processor.getStageProfiler().getSnapshot();
+
+    juce::AudioBuffer<float> output;
+    const auto fastestRun = useDouble ? render<double> (processor, input, output, automations, sampleRate, blockSize, numRepeats)
+                                      : render<float> (processor, input, output, automations, sampleRate, blockSize, numRepeats);
+
+    const auto profileAfter = processor.getStageProfiler().getSnapshot();
+
+    // report
+    const auto audioSeconds = (double) numSamples / sampleRate;
+    const auto nsPerSample = [numSamples] (double seconds) { return 1.0e9 * seconds / (double) numSamples; };
+
+    std::cout << juce::String (numChannels) << " channel(s), " << juce::String (numSamples) << " samples at "
+              << juce::String (sampleRate) << " Hz, block size " << juce::String (blockSize) << ", "
+              << (useDouble ? "double" : "single") << " precision, latency "
+              << juce::String (processor.getLatencySamples()) << " samples\n";
+    std::cout << "realtime factor: " << juce::String (audioSeconds / fastestRun, 1) << "x\n";
+    std::cout << "ns/sample:       " << juce::String (nsPerSample (fastestRun), 1) << " (fastest of " << juce::String (numRepeats) << ")\n";
+    std::cout << "idle:            " << juce::String (100.0 * (double) processor.getNumIdleSamples()
+                                                        / (double) juce::jmax (processor.getNumSamplesProcessed(), (juce::uint64) 1), 1)
+              << " % of samples bypassed\n";
+
+    std::array<double, StageProfiler::numStages> stageSeconds {};
+    double totalStageSeconds = 0.0;
+    for (size_t stage = 0; stage < (size_t) StageProfiler::numStages; ++stage)
+    {
+        stageSeconds[stage] = 1.0e-9 * (double) (profileAfter.nanoseconds[stage] - profileBefore.nanoseconds[stage]);
+        totalStageSeconds += stageSeconds[stage];
+    }
+
+    std::cout << "per stage (mean ns/sample):\n";
+    for (int stage = 0; stage < StageProfiler::numStages; ++stage)
+    {
+        const auto seconds = stageSeconds[(size_t) stage];
+        std::cout << "  " << juce::String (StageProfiler::stageNames[(size_t) stage]).paddedRight (' ', 14)
+                  << juce::String (nsPerSample (seconds / numRepeats), 1).paddedLeft (' ', 10)
+                  << juce::String (100.0 * seconds / juce::jmax (totalStageSeconds, 1.0e-12), 1).paddedLeft (' ', 8) << " %\n";
+    }
+
+    if (args.containsOption ("-o|--output"))
+        writeOutput (args.getFileForOption ("-o|--output"), output, sampleRate);
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <juce_dsp/juce_dsp.h>
+#include <chowdsp_math/chowdsp_math.h>
+
+#include "bench_utils.h"
+
+// FFT sizes from 64 to 65536
+constexpr int startOrder = 6;
+constexpr int endOrder = 16;
+
+template <typename FFTType>
+static void realFFTRoundTrip (benchmark::State& state)
+{
+    const auto order = (int) state.range (0);
+    const auto size = 1 << order;
+    FFTType fft { order };
+
+    const auto signal = bench_utils::makeRandomVector<float> (size);
+    std::vector<float> data ((size_t) size * 2, 0.0f);
+    for (auto _ : state)
+    {
+        std::copy (signal.begin(), signal.end(), data.begin());
+        fft.performRealOnlyForwardTransform (data.data());
+        fft.performRealOnlyInverseTransform (data.data());
+        benchmark::DoNotOptimize (data.data());
+    }
+}
+
+template <typename FFTType>
+static void complexFFT (benchmark::State& state)
+{
+    const auto order = (int) state.range (0);
+    const auto size = 1 << order;
+    FFTType fft { order };
+
+    const auto signalRe = bench_utils::makeRandomVector<float> (size);
+    const auto signalIm = bench_utils::makeRandomVector<float> (size);
+    std::vector<std::complex<float>> input ((size_t) size), output ((size_t) size);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = { signalRe[i], signalIm[i] };
+
+    for (auto _ : state)
+    {
+        fft.perform (input.data(), output.data(), false);
+        benchmark::DoNotOptimize (output.data());
+    }
+}
+
+static void JuceRealFFT (benchmark::State& state) { realFFTRoundTrip<juce::dsp::FFT> (state); }
+BENCHMARK (JuceRealFFT)->MinTime (1)->DenseRange (startOrder, endOrder);
+
+static void ChowRealFFT (benchmark::State& state) { realFFTRoundTrip<chowdsp::SIMDFFT> (state); }
+BENCHMARK (ChowRealFFT)->MinTime (1)->DenseRange (startOrder, endOrder);
+
+static void JuceComplexFFT (benchmark::State& state) { complexFFT<juce::dsp::FFT> (state); }
+BENCHMARK (JuceComplexFFT)->MinTime (1)->DenseRange (startOrder, endOrder);
+
+static void ChowComplexFFT (benchmark::State& state) { complexFFT<chowdsp::SIMDFFT> (state); }
+BENCHMARK (ChowComplexFFT)->MinTime (1)->DenseRange (startOrder, endOrder);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <juce_dsp/juce_dsp.h>
+#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
+
+#include "bench_utils.h"
+
+// IR sizes from 1024 to 16384, processed in blocks of 256 samples
+constexpr int blockSize = 256;
+constexpr int minIRSize = 1024;
+constexpr int maxIRSize = 16384;
+
+using MultiChannelEngine = chowdsp::MultiChannelConvolutionEngine<>;
+
+// (processed out-of-place, so that the signal doesn't build up from one block to the next)
+struct StereoBuffers
+{
+    std::vector<float> leftIn = bench_utils::makeRandomVector<float> (blockSize);
+    std::vector<float> rightIn = bench_utils::makeRandomVector<float> (blockSize);
+    std::vector<float> leftOut = std::vector<float> ((size_t) blockSize);
+    std::vector<float> rightOut = std::vector<float> ((size_t) blockSize);
+    std::vector<float> temp = std::vector<float> ((size_t) blockSize);
+
+    std::array<const float*, 2> inputs { leftIn.data(), rightIn.data() };
+    std::array<float*, 2> outputs { leftOut.data(), rightOut.data() };
+};
+
+// Stereo, with the same IR on both channels
+static void SeparateEnginesParallel (benchmark::State& state)
+{
+    const auto irSize = (size_t) state.range (0);
+    const auto ir = bench_utils::makeRandomVector<float> ((int) irSize);
+    chowdsp::ConvolutionEngine<> leftEngine { irSize, blockSize, ir.data() };
+    chowdsp::ConvolutionEngine<> rightEngine { irSize, blockSize, ir.data() };
+
+    StereoBuffers buffers;
+    for (auto _ : state)
+    {
+        leftEngine.processSamples (buffers.leftIn.data(), buffers.leftOut.data(), blockSize);
+        rightEngine.processSamples (buffers.rightIn.data(), buffers.rightOut.data(), blockSize);
+        benchmark::DoNotOptimize (buffers.outputs.data());
+    }
+}
+BENCHMARK (SeparateEnginesParallel)->MinTime (1)->RangeMultiplier (2)->Range (minIRSize, maxIRSize);
+
+static void MultiChannelParallel (benchmark::State& state)
+{
+    const auto irSize = (size_t) state.range (0);
+    const auto ir = bench_utils::makeRandomVector<float> ((int) irSize);
+    MultiChannelEngine engine { irSize, blockSize, 2, 2, MultiChannelEngine::getParallelRoutes (2) };
+    engine.setNewIR (0, ir.data());
+
+    StereoBuffers buffers;
+    for (auto _ : state)
+    {
+        engine.processSamples (buffers.inputs.data(), buffers.outputs.data(), blockSize);
+        benchmark::DoNotOptimize (buffers.outputs.data());
+    }
+}
+BENCHMARK (MultiChannelParallel)->MinTime (1)->RangeMultiplier (2)->Range (minIRSize, maxIRSize);
+
+// True stereo (a 2x2 matrix of IRs)
+static void SeparateEnginesTrueStereo (benchmark::State& state)
+{
+    const auto irSize = (size_t) state.range (0);
+    std::vector<std::unique_ptr<chowdsp::ConvolutionEngine<>>> engines;
+    for (int i = 0; i < 4; ++i)
+        engines.push_back (std::make_unique<chowdsp::ConvolutionEngine<>> (irSize, blockSize, bench_utils::makeRandomVector<float> ((int) irSize).data()));
+
+    StereoBuffers buffers;
+    for (auto _ : state)
+    {
+        engines[0]->processSamples (buffers.leftIn.data(), buffers.leftOut.data(), blockSize);
+        engines[1]->processSamples (buffers.rightIn.data(), buffers.temp.data(), blockSize);
+        juce::FloatVectorOperations::add (buffers.leftOut.data(), buffers.temp.data(), blockSize);
+
+        engines[2]->processSamples (buffers.leftIn.data(), buffers.rightOut.data(), blockSize);
+        engines[3]->processSamples (buffers.rightIn.data(), buffers.temp.data(), blockSize);
+        juce::FloatVectorOperations::add (buffers.rightOut.data(), buffers.temp.data(), blockSize);
+
+        benchmark::DoNotOptimize (buffers.outputs.data());
+    }
+}
+BENCHMARK (SeparateEnginesTrueStereo)->MinTime (1)->RangeMultiplier (2)->Range (minIRSize, maxIRSize);
+
+static void MultiChannelTrueStereo (benchmark::State& state)
+{
+    const auto irSize = (size_t) state.range (0);
+    MultiChannelEngine engine { irSize, blockSize, 2, 2, MultiChannelEngine::getTrueStereoRoutes() };
+    for (size_t i = 0; i < engine.getNumIRs(); ++i)
+        engine.setNewIR (i, bench_utils::makeRandomVector<float> ((int) irSize).data());
+
+    StereoBuffers buffers;
+    for (auto _ : state)
+    {
+        engine.processSamples (buffers.inputs.data(), buffers.outputs.data(), blockSize);
+        benchmark::DoNotOptimize (buffers.outputs.data());
+    }
+}
+BENCHMARK (MultiChannelTrueStereo)->MinTime (1)->RangeMultiplier (2)->Range (minIRSize, maxIRSize);
+
+BENCHMARK_MAIN();
@@ -13,12 +13,17 @@ ConvolutionEngine<FFTEngineType>::ConvolutionEngine (size_t numSamples, size_t m
       bufferInput (1, static_cast<int> (fftSize)),
       bufferOutput (1, static_cast<int> (fftSize * 2)),
       bufferTempOutput (1, static_cast<int> (fftSize * 2)),
-      bufferOverlap (1, static_cast<int> (fftSize))
+      bufferOverlap (1, static_cast<int> (fftSize)),
+      bufferIncomingOutput (1, static_cast<int> (fftSize * 2)),
+      bufferIncomingTempOutput (1, static_cast<int> (fftSize * 2)),
+      bufferIncomingOverlap (1, static_cast<int> (fftSize))
 {
     bufferOutput.clear();
+    bufferIncomingOutput.clear();
 
     updateSegmentsIfNecessary (numInputSegments, buffersInputSegments, fftSize);
     updateSegmentsIfNecessary (numSegments, buffersImpulseSegments, fftSize);
+    updateSegmentsIfNecessary (numSegments, buffersIncomingImpulseSegments, fftSize);
 
     if (initialIR != nullptr)
         setNewIR (initialIR);
@@ -40,7 +45,16 @@ ConvolutionEngine<FFTEngineType>::ConvolutionEngine (ConvolutionEngine&& other)
                                                                                            bufferTempOutput (std::move (other.bufferTempOutput)),
                                                                                            bufferOverlap (std::move (other.bufferOverlap)),
                                                                                            buffersInputSegments (std::move (other.buffersInputSegments)),
-                                                                                           buffersImpulseSegments (std::move (other.buffersImpulseSegments))
+                                                                                           buffersImpulseSegments (std::move (other.buffersImpulseSegments)),
+                                                                                           crossfadeState (other.crossfadeState),
+                                                                                           crossfadeNumBlocks (other.crossfadeNumBlocks),
+                                                                                           crossfadeBlocksRemaining (other.crossfadeBlocksRemaining),
+                                                                                           crossfadeGain (other.crossfadeGain),
+                                                                                           crossfadeGainIncrement (other.crossfadeGainIncrement),
+                                                                                           bufferIncomingOutput (std::move (other.bufferIncomingOutput)),
+                                                                                           bufferIncomingTempOutput (std::move (other.bufferIncomingTempOutput)),
+                                                                                           bufferIncomingOverlap (std::move (other.bufferIncomingOverlap)),
+                                                                                           buffersIncomingImpulseSegments (std::move (other.buffersIncomingImpulseSegments))
 {
 }
 
@@ -71,10 +85,17 @@ void ConvolutionEngine<FFTEngineType>::updateSegmentsIfNecessary (size_t numSegm
 template <typename FFTEngineType>
 void ConvolutionEngine<FFTEngineType>::reset()
 {
+    // with no history left to fade out, the incoming IR can take over straight away
+    if (isCrossfading())
+        finishCrossfade();
+
     bufferInput.clear();
     bufferOverlap.clear();
     bufferTempOutput.clear();
     bufferOutput.clear();
+    bufferIncomingOverlap.clear();
+    bufferIncomingTempOutput.clear();
+    bufferIncomingOutput.clear();
 
     for (auto& buf : buffersInputSegments)
         buf.clear();
@@ -85,6 +106,8 @@ void ConvolutionEngine<FFTEngineType>::reset()
 template <typename FFTEngineType>
 void ConvolutionEngine<FFTEngineType>::setNewIR (const float* newIR)
 {
+    crossfadeState = CrossfadeState::None;
+
     size_t currentPtr = 0;
     for (auto& buf : buffersImpulseSegments)
     {
@@ -104,18 +127,142 @@ void ConvolutionEngine<FFTEngineType>::setNewIR (const float* newIR)
         currentPtr += (fftSize - blockSize);
     }
 }
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::crossfadeToIR (const std::vector<juce::AudioBuffer<float>>& newImpulseSegments, size_t numCrossfadeBlocks)
+{
+    jassert (newImpulseSegments.size() == buffersIncomingImpulseSegments.size());
+    jassert (! isCrossfading()); // wait for the previous crossfade to finish!
+
+    for (size_t i = 0; i < newImpulseSegments.size(); ++i)
+    {
+        juce::FloatVectorOperations::copy (buffersIncomingImpulseSegments[i].getWritePointer (0),
+                                           newImpulseSegments[i].getReadPointer (0),
+                                           newImpulseSegments[i].getNumSamples());
+    }
+
+    crossfadeNumBlocks = juce::jmax ((size_t) 1, numCrossfadeBlocks);
+    crossfadeState = CrossfadeState::Pending;
+}
+
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::advanceCrossfade()
+{
+    switch (crossfadeState)
+    {
+        case CrossfadeState::None:
+            break;
+
+        case CrossfadeState::Pending:
+            // Each block's output overlaps with the next (fftSize / blockSize - 1) blocks,
+            // so the incoming IR needs that many blocks before its output is complete.
+            crossfadeState = CrossfadeState::WarmUp;
+            crossfadeBlocksRemaining = fftSize / blockSize - 1;
+            break;
+
+        case CrossfadeState::WarmUp:
+            if (--crossfadeBlocksRemaining == 0)
+            {
+                crossfadeState = CrossfadeState::Fading;
+                crossfadeBlocksRemaining = crossfadeNumBlocks;
+                crossfadeGain = 0.0f;
+                crossfadeGainIncrement = 1.0f / float (crossfadeNumBlocks * blockSize);
+            }
+            break;
+
+        case CrossfadeState::Fading:
+            if (--crossfadeBlocksRemaining == 0)
+                finishCrossfade();
+            break;
+    }
+}
+
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::finishCrossfade()
+{
+    std::swap (buffersImpulseSegments, buffersIncomingImpulseSegments);
+    juce::FloatVectorOperations::copy (bufferOverlap.getWritePointer (0), bufferIncomingOverlap.getReadPointer (0), (int) fftSize);
+    crossfadeState = CrossfadeState::None;
+}
+
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::applyCrossfade (float* output, const float* incomingOutput, size_t numSamples) noexcept
+{
+    for (size_t n = 0; n < numSamples; ++n)
+    {
+        output[n] += crossfadeGain * (incomingOutput[n] - output[n]);
+        crossfadeGain += crossfadeGainIncrement;
+    }
+}
+
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::accumulatePastSegments (const std::vector<juce::AudioBuffer<float>>& impulseSegments, float* outputTempData) const
+{
+    juce::FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+    accumulateSegments (impulseSegments, outputTempData, 1, numSegments);
+}
+
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::accumulateSegments (const std::vector<juce::AudioBuffer<float>>& impulseSegments,
+                                                           float* outputTempData,
+                                                           size_t firstSegment,
+                                                           size_t endSegment) const
+{
+    const auto indexStep = numInputSegments / numSegments;
+
+    auto index = (currentSegment + firstSegment * indexStep) % numInputSegments;
+
+    for (size_t i = firstSegment; i < endSegment; ++i)
+    {
+        convolutionProcessingAndAccumulate (buffersInputSegments[index].getReadPointer (0),
+                                            impulseSegments[i].getReadPointer (0),
+                                            outputTempData);
+
+        index += indexStep;
+
+        if (index >= numInputSegments)
+            index -= numInputSegments;
+    }
+}
+
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::computeOutput (const float* inputSegmentData,
+                                                      const std::vector<juce::AudioBuffer<float>>& impulseSegments,
+                                                      const float* outputTempData,
+                                                      float* outputData) const
+{
+    juce::FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
+
+    convolutionProcessingAndAccumulate (inputSegmentData,
+                                        impulseSegments.front().getReadPointer (0),
+                                        outputData);
+
+    updateSymmetricFrequencyDomainData (outputData);
+    fftObject->performRealOnlyInverseTransform (outputData);
+}
+
+template <typename FFTEngineType>
+void ConvolutionEngine<FFTEngineType>::saveOverlap (float* outputData, float* overlapData) const noexcept
+{
+    // Extra step for segSize > blockSize
+    juce::FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
+
+    // Save the overlap
+    juce::FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+}
+
 template <typename FFTEngineType>
 void ConvolutionEngine<FFTEngineType>::processSamples (const float* input, float* output, size_t numSamples)
 {
     // Overlap-add, zero latency convolution algorithm with uniform partitioning
     size_t numSamplesProcessed = 0;
 
-    auto indexStep = numInputSegments / numSegments;
-
     auto* inputData = bufferInput.getWritePointer (0);
     auto* outputTempData = bufferTempOutput.getWritePointer (0);
     auto* outputData = bufferOutput.getWritePointer (0);
     auto* overlapData = bufferOverlap.getWritePointer (0);
+    auto* incomingOutputTempData = bufferIncomingTempOutput.getWritePointer (0);
+    auto* incomingOutputData = bufferIncomingOutput.getWritePointer (0);
+    auto* incomingOverlapData = bufferIncomingOverlap.getWritePointer (0);
 
     while (numSamplesProcessed < numSamples)
     {
@@ -133,35 +280,27 @@ void ConvolutionEngine<FFTEngineType>::processSamples (const float* input, float
         // Complex multiplication
         if (inputDataWasEmpty)
         {
-            juce::FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
-
-            auto index = currentSegment;
+            advanceCrossfade();
 
-            for (size_t i = 1; i < numSegments; ++i)
-            {
-                index += indexStep;
-
-                if (index >= numInputSegments)
-                    index -= numInputSegments;
-
-                convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                    buffersImpulseSegments[i].getWritePointer (0),
-                                                    outputTempData);
-            }
+            accumulatePastSegments (buffersImpulseSegments, outputTempData);
+            if (isProcessingIncomingIR())
+                accumulatePastSegments (buffersIncomingImpulseSegments, incomingOutputTempData);
         }
 
-        juce::FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
-
-        convolutionProcessingAndAccumulate (inputSegmentData,
-                                            buffersImpulseSegments.front().getWritePointer (0),
-                                            outputData);
-
-        updateSymmetricFrequencyDomainData (outputData);
-        fftObject->performRealOnlyInverseTransform (outputData);
+        computeOutput (inputSegmentData, buffersImpulseSegments, outputTempData, outputData);
 
         // Add overlap
         juce::FloatVectorOperations::add (&output[numSamplesProcessed], &outputData[inputDataPos], &overlapData[inputDataPos], (int) numSamplesToProcess);
 
+        if (isProcessingIncomingIR())
+        {
+            computeOutput (inputSegmentData, buffersIncomingImpulseSegments, incomingOutputTempData, incomingOutputData);
+            juce::FloatVectorOperations::add (&incomingOutputData[inputDataPos], &incomingOverlapData[inputDataPos], (int) numSamplesToProcess);
+
+            if (crossfadeState == CrossfadeState::Fading)
+                applyCrossfade (&output[numSamplesProcessed], &incomingOutputData[inputDataPos], numSamplesToProcess);
+        }
+
         // Input buffer full => Next block
         inputDataPos += numSamplesToProcess;
 
@@ -172,11 +311,9 @@ void ConvolutionEngine<FFTEngineType>::processSamples (const float* input, float
 
             inputDataPos = 0;
 
-            // Extra step for segSize > blockSize
-            juce::FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
-
-            // Save the overlap
-            juce::FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+            saveOverlap (outputData, overlapData);
+            if (isProcessingIncomingIR())
+                saveOverlap (incomingOutputData, incomingOverlapData);
 
             currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
         }
@@ -190,12 +327,13 @@ void ConvolutionEngine<FFTEngineType>::processSamplesWithAddedLatency (const flo
     // Overlap-add, zero latency convolution algorithm with uniform partitioning
     size_t numSamplesProcessed = 0;
 
-    auto indexStep = numInputSegments / numSegments;
-
     auto* inputData = bufferInput.getWritePointer (0);
     auto* outputTempData = bufferTempOutput.getWritePointer (0);
     auto* outputData = bufferOutput.getWritePointer (0);
     auto* overlapData = bufferOverlap.getWritePointer (0);
+    auto* incomingOutputTempData = bufferIncomingTempOutput.getWritePointer (0);
+    auto* incomingOutputData = bufferIncomingOutput.getWritePointer (0);
+    auto* incomingOverlapData = bufferIncomingOverlap.getWritePointer (0);
 
     while (numSamplesProcessed < numSamples)
     {
@@ -205,6 +343,9 @@ void ConvolutionEngine<FFTEngineType>::processSamplesWithAddedLatency (const flo
 
         juce::FloatVectorOperations::copy (output + numSamplesProcessed, outputData + inputDataPos, static_cast<int> (numSamplesToProcess));
 
+        if (crossfadeState == CrossfadeState::Fading)
+            applyCrossfade (output + numSamplesProcessed, incomingOutputData + inputDataPos, numSamplesToProcess);
+
         numSamplesProcessed += numSamplesToProcess;
         inputDataPos += numSamplesToProcess;
 
@@ -219,43 +360,27 @@ void ConvolutionEngine<FFTEngineType>::processSamplesWithAddedLatency (const flo
             prepareForConvolution (inputSegmentData, fftSize);
 
             // Complex multiplication
-            juce::FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+            advanceCrossfade();
 
-            auto index = currentSegment;
+            accumulatePastSegments (buffersImpulseSegments, outputTempData);
+            computeOutput (inputSegmentData, buffersImpulseSegments, outputTempData, outputData);
 
-            for (size_t i = 1; i < numSegments; ++i)
-            {
-                index += indexStep;
+            // Add overlap
+            juce::FloatVectorOperations::add (outputData, overlapData, static_cast<int> (blockSize));
+            saveOverlap (outputData, overlapData);
 
-                if (index >= numInputSegments)
-                    index -= numInputSegments;
+            if (isProcessingIncomingIR())
+            {
+                accumulatePastSegments (buffersIncomingImpulseSegments, incomingOutputTempData);
+                computeOutput (inputSegmentData, buffersIncomingImpulseSegments, incomingOutputTempData, incomingOutputData);
 
-                convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                    buffersImpulseSegments[i].getWritePointer (0),
-                                                    outputTempData);
+                juce::FloatVectorOperations::add (incomingOutputData, incomingOverlapData, static_cast<int> (blockSize));
+                saveOverlap (incomingOutputData, incomingOverlapData);
             }
 
-            juce::FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
-
-            convolutionProcessingAndAccumulate (inputSegmentData,
-                                                buffersImpulseSegments.front().getWritePointer (0),
-                                                outputData);
-
-            updateSymmetricFrequencyDomainData (outputData);
-            fftObject->performRealOnlyInverseTransform (outputData);
-
-            // Add overlap
-            juce::FloatVectorOperations::add (outputData, overlapData, static_cast<int> (blockSize));
-
             // Input buffer is empty again now
             juce::FloatVectorOperations::fill (inputData, 0.0f, static_cast<int> (fftSize));
 
-            // Extra step for segSize > blockSize
-            juce::FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
-
-            // Save the overlap
-            juce::FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
-
             currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
 
             inputDataPos = 0;
@@ -7,39 +7,33 @@ namespace chowdsp
  *  filters, where the filter might change, but the IR size remains constant.
  * 
  *  To change the filter smoothly in real-time, it is recommended to use
- *  the IRTransfer class so the IR can be computed on a separate thread:
+ *  the IRTransfer class so the IR can be computed on a separate thread,
+ *  and the engines can crossfade to it over a few blocks:
  *  ```
- *  std::unique_ptr<ConvolutionEngine> engine[2]; // stereo convolution
+ *  std::vector<std::unique_ptr<ConvolutionEngine<>>> engines; // one per channel
  *  std::unique_ptr<IRTransfer> irTransfer;
  *
  *  // in prepareToPlay()
- *  for (auto& eng : engine)
- *      eng = std::make_unique<ConvolutionEngine> (initialIR, irSize, blockSize);
+ *  for (size_t ch = 0; ch < numChannels; ++ch)
+ *      engines.push_back (std::make_unique<ConvolutionEngine<>> (irSize, blockSize, initialIR));
+ *
+ *  irTransfer = std::make_unique<IRTransfer> (*engines[0]);
  *
- *  irTransfer = std::make_unique<IRTransfer> (*engine[0]);
- *  
  *  // when a new IR is ready (on a separate thread)
  *  irTransfer->setNewIR (newIRBuffer);
- * 
+ *
  *  // in audio callback:
- *  { // if IR update is needed...
- *      SpinLock::ScopedTryLockType lock (irTransfer->mutex);
- *      if (lock.isLocked())
- *      {
- *          for (auto& eng : engine)
- *              irTransfer->transferIR (*eng);
- *      }
- * }
+ *  irTransfer->transferIR (engines); // starts a crossfade if there's a new IR
  *
  *  for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
  *  {
- *      engine[ch]->processSamplesWithAddedLatency (block.getChannelPointer (ch),
- *                                                  block.getChannelPointer (ch),
- *                                                  block.getNumSamples());
+ *      engines[ch]->processSamples (block.getChannelPointer (ch),
+ *                                   block.getChannelPointer (ch),
+ *                                   block.getNumSamples());
  *  }
  *  ```
  */
-template <typename FFTEngineType = juce::dsp::FFT>
+template <typename FFTEngineType = DefaultFFT>
 struct ConvolutionEngine
 {
     /** Creates a new convolution engine for a given IR, note that while future IRs
@@ -61,6 +55,20 @@ struct ConvolutionEngine
     // sets these samples as the new IR
     void setNewIR (const float* newIR);
 
+    /**
+     * Starts crossfading to a new set of IR segments (as prepared by IRTransfer), over some number of blocks.
+     *
+     * The fade starts at the next block boundary, once the new IR's overlap has been built up, and
+     * until it finishes, both IRs are applied to the same input spectra. That doubles the cost of
+     * the convolution for (fftSize / blockSize - 1 + numCrossfadeBlocks) blocks: every block does
+     * the full set of spectral multiplies (one per IR segment) and an inverse FFT for each IR, and
+     * only the forward FFT of the input is shared. The segments are copied, so no FFTs are done here.
+     */
+    void crossfadeToIR (const std::vector<juce::AudioBuffer<float>>& newImpulseSegments, size_t numCrossfadeBlocks);
+
+    // returns true if a crossfade to a new IR has been started, but not yet finished
+    [[nodiscard]] bool isCrossfading() const noexcept { return crossfadeState != CrossfadeState::None; }
+
     // process samples with zero latency
     void processSamples (const float* input, float* output, size_t numSamples);
 
@@ -81,6 +89,27 @@ struct ConvolutionEngine
     // second half, so that the inverse transform will return real samples in the time domain.
     void updateSymmetricFrequencyDomainData (float* samples) const noexcept;
 
+    // Sums the contributions of every input segment except the current one, for a set of IR segments.
+    void accumulatePastSegments (const std::vector<juce::AudioBuffer<float>>& impulseSegments, float* outputTempData) const;
+
+    // Adds the contributions of the input segments from firstSegment (up to, but not including, endSegment)
+    // blocks ago, so that the past segments can be accumulated a few at a time.
+    void accumulateSegments (const std::vector<juce::AudioBuffer<float>>& impulseSegments, float* outputTempData, size_t firstSegment, size_t endSegment) const;
+
+    // Adds the current input segment's contribution to the past segments, and transforms the result back to the time domain.
+    void computeOutput (const float* inputSegmentData, const std::vector<juce::AudioBuffer<float>>& impulseSegments, const float* outputTempData, float* outputData) const;
+
+    // Saves the part of the output that overlaps with the following blocks.
+    void saveOverlap (float* outputData, float* overlapData) const noexcept;
+
+    // Moves the crossfade on to its next stage, at a block boundary.
+    void advanceCrossfade();
+    void finishCrossfade();
+    [[nodiscard]] bool isProcessingIncomingIR() const noexcept { return crossfadeState == CrossfadeState::WarmUp || crossfadeState == CrossfadeState::Fading; }
+
+    // Fades the output from the current IR to the incoming IR.
+    void applyCrossfade (float* output, const float* incomingOutput, size_t numSamples) noexcept;
+
     //==============================================================================
     const size_t irNumSamples;
     const size_t blockSize;
@@ -93,6 +122,21 @@ struct ConvolutionEngine
     juce::AudioBuffer<float> bufferInput, bufferOutput, bufferTempOutput, bufferOverlap;
     std::vector<juce::AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
 
+    // The IR being crossfaded to, and the output state that goes with it
+    enum class CrossfadeState
+    {
+        None,
+        Pending, // waiting for the next block boundary
+        WarmUp, // building up the overlap for the incoming IR
+        Fading,
+    };
+    CrossfadeState crossfadeState = CrossfadeState::None;
+    size_t crossfadeNumBlocks = 0, crossfadeBlocksRemaining = 0;
+    float crossfadeGain = 0.0f, crossfadeGainIncrement = 0.0f;
+
+    juce::AudioBuffer<float> bufferIncomingOutput, bufferIncomingTempOutput, bufferIncomingOverlap;
+    std::vector<juce::AudioBuffer<float>> buffersIncomingImpulseSegments;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionEngine)
 };
 } // namespace chowdsp
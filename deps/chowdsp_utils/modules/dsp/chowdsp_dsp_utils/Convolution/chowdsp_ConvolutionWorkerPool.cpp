@@ -0,0 +1,319 @@
+#include "chowdsp_ConvolutionWorkerPool.h"
+
+namespace chowdsp
+{
+ConvolutionWorkerPool::Task::~Task()
+{
+    // The task must be removed from its pool before it gets destroyed,
+    // otherwise the pool might try to run it while it's half gone!
+    jassert (pool.load() == nullptr || state.load() == Removed);
+}
+
+void ConvolutionWorkerPool::Task::queue (double timeToDeadlineMs) noexcept
+{
+    auto* taskPool = pool.load();
+    jassert (taskPool != nullptr); // the task needs to be added to a pool first!
+    jassert (state.load() == Idle); // the task is already queued, or has been removed from the pool!
+
+    const auto queueTimeMs = juce::Time::getMillisecondCounterHiRes();
+    requestTimeMs.store (queueTimeMs, std::memory_order_relaxed);
+    deadlineMs.store (queueTimeMs + timeToDeadlineMs, std::memory_order_relaxed);
+    queueOrder.store (taskPool->queueCounter.fetch_add (1), std::memory_order_relaxed);
+    taskPool->queueDepth.fetch_add (1);
+    state.store (Queued, std::memory_order_release);
+
+    taskPool->wakeUpWorker();
+}
+
+bool ConvolutionWorkerPool::Task::isFinished() const noexcept
+{
+    const auto currentState = state.load (std::memory_order_acquire);
+    return currentState == Idle || currentState == Removed;
+}
+
+bool ConvolutionWorkerPool::Task::tryClaim() noexcept
+{
+    auto expected = (int) Queued;
+    if (! state.compare_exchange_strong (expected, Claimed, std::memory_order_acq_rel))
+        return false;
+
+    pool.load()->queueDepth.fetch_sub (1);
+    return true;
+}
+
+void ConvolutionWorkerPool::Task::release() noexcept
+{
+    jassert (state.load() == Claimed);
+    state.store (Idle, std::memory_order_release);
+}
+
+void ConvolutionWorkerPool::Task::cancel()
+{
+    // a worker only ever holds on to a task for one slice
+    while (! isFinished())
+    {
+        if (tryClaim())
+        {
+            release();
+            return;
+        }
+
+        juce::Thread::yield();
+    }
+}
+
+//==============================================================================
+void ConvolutionWorkerPool::Job::requestRun() noexcept
+{
+    ConvolutionWorkerPool::requestRun (*this);
+}
+
+bool ConvolutionWorkerPool::Job::runSlice()
+{
+    runJob();
+    return true;
+}
+
+void ConvolutionWorkerPool::requestRun (Task& task) noexcept
+{
+    auto* taskPool = task.pool.load();
+    if (taskPool == nullptr)
+        return;
+
+    // counted before a worker can pick the job up
+    taskPool->queueDepth.fetch_add (1);
+
+    auto currentState = task.state.load();
+    while (true)
+    {
+        // If the job is already waiting for a worker (or has been removed), there's
+        // nothing to do. Otherwise, this is the first request since a worker last
+        // picked the job up, so that's where its latency is measured from.
+        if (currentState != Task::Idle && currentState != Task::Running)
+        {
+            taskPool->queueDepth.fetch_sub (1);
+            return;
+        }
+
+        task.requestTimeMs.store (juce::Time::getMillisecondCounterHiRes(), std::memory_order_relaxed);
+        task.deadlineMs.store (std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+        task.queueOrder.store (taskPool->queueCounter.fetch_add (1), std::memory_order_relaxed);
+
+        const auto newState = currentState == Task::Idle ? Task::Queued : Task::RunningAndRequested;
+        if (task.state.compare_exchange_weak (currentState, newState, std::memory_order_acq_rel))
+            break;
+    }
+
+    // (if the job is running, the worker that's running it will see the request when it's done)
+    if (currentState == Task::Idle)
+        taskPool->wakeUpWorker();
+}
+
+//==============================================================================
+int ConvolutionWorkerPool::getDefaultNumThreads()
+{
+    return juce::jlimit (1, 4, juce::SystemStats::getNumCpus() / 2);
+}
+
+ConvolutionWorkerPool::ConvolutionWorkerPool() : ConvolutionWorkerPool (getDefaultNumThreads())
+{
+}
+
+ConvolutionWorkerPool::ConvolutionWorkerPool (int numThreads)
+{
+    jassert (numThreads > 0);
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads.push_back (std::make_unique<WorkerThread> (*this));
+        threads.back()->startThread();
+    }
+}
+
+ConvolutionWorkerPool::~ConvolutionWorkerPool()
+{
+    // all the tasks should have been removed by now!
+    jassert (tasks.empty());
+
+    for (auto& thread : threads)
+        thread->signalThreadShouldExit();
+
+    // each thread passes the wake-up on as it exits
+    wakeUpWorker();
+    for (auto& thread : threads)
+        thread->stopThread (-1);
+}
+
+void ConvolutionWorkerPool::addTask (Task& task)
+{
+    // this task is already part of a pool!
+    jassert (task.pool.load() == nullptr || task.state.load() == Task::Removed);
+
+    const juce::ScopedLock sl { tasksLock };
+    tasks.push_back (&task);
+    task.state.store (Task::Idle);
+    task.pool.store (this);
+}
+
+void ConvolutionWorkerPool::removeTask (Task& task)
+{
+    {
+        const juce::ScopedLock sl { tasksLock };
+        const auto taskIter = std::find (tasks.begin(), tasks.end(), &task);
+        if (taskIter == tasks.end())
+            return;
+
+        tasks.erase (taskIter);
+    }
+
+    // Now no worker can pick the task up again, but one might be running it, or
+    // the thread that queued it might have claimed it. Once it's been marked as
+    // removed, any more requests to run it are ignored.
+    auto currentState = task.state.load();
+    while (true)
+    {
+        if (currentState != Task::Idle && currentState != Task::Queued)
+        {
+            juce::Thread::yield();
+            currentState = task.state.load();
+            continue;
+        }
+
+        if (task.state.compare_exchange_weak (currentState, Task::Removed, std::memory_order_acq_rel))
+            break;
+    }
+
+    if (currentState == Task::Queued)
+        queueDepth.fetch_sub (1);
+}
+
+void ConvolutionWorkerPool::resetLatencyStats() noexcept
+{
+    lastLatencyMs.store (0.0);
+    maxLatencyMs.store (0.0);
+}
+
+ConvolutionWorkerPool::Task* ConvolutionWorkerPool::claimMostUrgentTask (double& requestTimeMs)
+{
+    const juce::ScopedLock sl { tasksLock };
+
+    while (true)
+    {
+        Task* mostUrgentTask = nullptr;
+        double mostUrgentDeadline = 0.0;
+        uint32_t mostUrgentQueueOrder = 0;
+        int numQueuedTasks = 0;
+        for (auto* task : tasks)
+        {
+            if (task->state.load (std::memory_order_acquire) != Task::Queued)
+                continue;
+
+            numQueuedTasks++;
+            const auto taskDeadline = task->deadlineMs.load (std::memory_order_relaxed);
+            const auto taskQueueOrder = task->queueOrder.load (std::memory_order_relaxed);
+            if (mostUrgentTask == nullptr
+                || taskDeadline < mostUrgentDeadline
+                || (taskDeadline == mostUrgentDeadline && (int32_t) (taskQueueOrder - mostUrgentQueueOrder) < 0))
+            {
+                mostUrgentTask = task;
+                mostUrgentDeadline = taskDeadline;
+                mostUrgentQueueOrder = taskQueueOrder;
+            }
+        }
+
+        if (mostUrgentTask == nullptr)
+            return nullptr;
+
+        // Read the request time before claiming the task: a request that comes in
+        // while it's running is timed from then, for the next run.
+        requestTimeMs = mostUrgentTask->requestTimeMs.load (std::memory_order_relaxed);
+
+        numRunningTasks.fetch_add (1);
+        auto expected = (int) Task::Queued;
+        if (! mostUrgentTask->state.compare_exchange_strong (expected, Task::Running, std::memory_order_acq_rel))
+        {
+            numRunningTasks.fetch_sub (1);
+            continue; // the audio thread got there first
+        }
+
+        queueDepth.fetch_sub (1);
+
+        // if there's more work queued up, wake up another thread to help out
+        if (numQueuedTasks > 1)
+            wakeUpWorker();
+
+        return mostUrgentTask;
+    }
+}
+
+void ConvolutionWorkerPool::finishSlice (Task& task, bool isFinished, double requestTimeMs)
+{
+    if (isFinished)
+    {
+        const auto latencyMs = juce::Time::getMillisecondCounterHiRes() - requestTimeMs;
+        lastLatencyMs.store (latencyMs);
+
+        auto prevMaxLatencyMs = maxLatencyMs.load();
+        while (latencyMs > prevMaxLatencyMs && ! maxLatencyMs.compare_exchange_weak (prevMaxLatencyMs, latencyMs))
+        {
+        }
+    }
+
+    // Put the task back in the queue after each slice, so that a more urgent task
+    // that has come in since can go first. The pool mustn't touch the task after
+    // this, since it might be getting removed.
+    if (! isFinished)
+        queueDepth.fetch_add (1);
+
+    auto expected = (int) Task::Running;
+    if (! task.state.compare_exchange_strong (expected, isFinished ? Task::Idle : Task::Queued, std::memory_order_acq_rel))
+    {
+        // the job was requested again while it was running (and that's already been counted)
+        jassert (expected == Task::RunningAndRequested);
+        task.state.store (Task::Queued, std::memory_order_release);
+    }
+
+    numRunningTasks.fetch_sub (1);
+}
+
+void ConvolutionWorkerPool::WorkerThread::run()
+{
+    while (! threadShouldExit())
+    {
+        double requestTimeMs = 0.0;
+        auto* task = pool.claimMostUrgentTask (requestTimeMs);
+        if (task == nullptr)
+        {
+            pool.waitForWakeUp();
+            continue;
+        }
+
+        const auto isFinished = task->runSlice();
+        pool.finishSlice (*task, isFinished, requestTimeMs);
+    }
+
+    // pass the wake-up on, so that the other threads can exit too
+    pool.wakeUpWorker();
+}
+
+void ConvolutionWorkerPool::wakeUpWorker() noexcept
+{
+    // One pending wake-up is enough, since a worker that wakes up runs
+    // everything that's queued before it goes back to sleep.
+    auto numWakeUps = pendingWakeUps.load();
+    do
+    {
+        if (numWakeUps > 0)
+            return;
+    } while (! pendingWakeUps.compare_exchange_weak (numWakeUps, numWakeUps + 1));
+
+    // only go to the OS if a worker is asleep
+    if (numWakeUps < 0)
+        wakeUpSemaphore.signal();
+}
+
+void ConvolutionWorkerPool::waitForWakeUp()
+{
+    if (pendingWakeUps.fetch_sub (1) <= 0)
+        wakeUpSemaphore.wait();
+}
+} // namespace chowdsp
@@ -0,0 +1,248 @@
+#pragma once
+
+namespace chowdsp
+{
+/**
+ * A small, bounded pool of worker threads, that does the background work for all the
+ * convolution processors in the process (via juce::SharedResourcePointer), so that a
+ * plugin with lots of them doesn't need a thread for each one.
+ *
+ * There are two kinds of work:
+ * - A Task (e.g. a tail stage of a NonUniformConvolutionEngine) has to be finished
+ *   by a deadline, and does its work in slices. A task's deadline is the time it was
+ *   queued at, plus however long its owner can give it (e.g. one partition), and after
+ *   every slice, a worker picks up whichever queued task is due first (or the one that
+ *   was queued first, if two are due at the same time). So a big task can hold up a
+ *   smaller one for (at most) a slice, and a big task that has been waiting for a while
+ *   still goes before a small one that is due later. The thread that queued a task
+ *   (i.e. the audio thread) can also take it back at any time, if none of the workers
+ *   is in the middle of one of its slices (see Task::tryClaim()), so a late task can be
+ *   finished without waiting for a worker.
+ * - A Job (e.g. re-computing the IR of a LinearPhaseEQ) has no deadline, so it only
+ *   runs when none of the tasks are queued, in the order the jobs were requested in.
+ *   See Job::requestRun().
+ *
+ * Queueing a task or requesting a job doesn't take any locks: the workers sleep on
+ * an OS semaphore, which only gets posted if one of them is actually asleep.
+ */
+class ConvolutionWorkerPool
+{
+public:
+    /** Creates a pool with a default number of threads, depending on the number of CPUs. */
+    ConvolutionWorkerPool();
+
+    /** Creates a pool with a given number of threads. */
+    explicit ConvolutionWorkerPool (int numThreads);
+
+    ~ConvolutionWorkerPool();
+
+    /** A task that can be run on a ConvolutionWorkerPool, one slice at a time. */
+    class Task
+    {
+    public:
+        Task() = default;
+        virtual ~Task();
+
+        /** Runs the next slice of work, and returns true once the task is finished. */
+        virtual bool runSlice() = 0;
+
+        /**
+         * Queues the task to be run on the pool, and finished within some number of
+         * milliseconds from now. The task must be finished (or cancelled) before it is
+         * queued again. This doesn't lock or allocate, so it can be called from the
+         * audio thread.
+         */
+        void queue (double timeToDeadlineMs) noexcept;
+
+        /** Returns true if the task isn't queued, or being run. */
+        [[nodiscard]] bool isFinished() const noexcept;
+
+        /**
+         * Takes the task back from the pool, so that the caller can finish it (or drop it), and
+         * returns true. This fails if a worker is running one of the task's slices right now, or
+         * if the task isn't queued. Once a task has been claimed, call release() when it's done
+         * with. This is lock-free.
+         */
+        bool tryClaim() noexcept;
+
+        /** Marks a claimed task as finished. */
+        void release() noexcept;
+
+        /**
+         * Drops the task if it's queued, after waiting for the slice that's currently running
+         * (if there is one) to finish. This is not real-time safe.
+         */
+        void cancel();
+
+    private:
+        friend class ConvolutionWorkerPool;
+
+        enum State
+        {
+            Idle,
+            Queued,
+            Running, // on a worker
+            RunningAndRequested, // on a worker, and requested to run again afterwards (jobs only)
+            Claimed, // by the thread that queued it
+            Removed, // from the pool
+        };
+        std::atomic<int> state { Idle };
+
+        std::atomic<ConvolutionWorkerPool*> pool { nullptr };
+        std::atomic<double> deadlineMs { 0.0 };
+        std::atomic<uint32_t> queueOrder { 0 };
+        std::atomic<double> requestTimeMs { 0.0 };
+
+        JUCE_DECLARE_NON_COPYABLE (Task)
+    };
+
+    /**
+     * A job that can be run on a ConvolutionWorkerPool, whenever the pool has nothing
+     * more urgent to do.
+     *
+     * Requests are coalesced: a job is only ever queued once, so if it's requested again
+     * before it starts, nothing extra is queued (the job should just use the latest
+     * parameters when it runs, see LatestParameters). If it's requested while it's
+     * running, it'll run once more afterwards. Jobs are never run on more than one
+     * thread at a time.
+     */
+    class Job : private Task
+    {
+    public:
+        Job() = default;
+        ~Job() override = default;
+
+        /** Does the job, on one of the pool's threads. */
+        virtual void runJob() = 0;
+
+        /**
+         * Asks for this job to be run. This doesn't lock or allocate, so it can be called
+         * from the audio thread, and may be called from any thread. Requests made after the
+         * job has been removed from its pool are ignored.
+         */
+        void requestRun() noexcept;
+
+    private:
+        friend class ConvolutionWorkerPool;
+        bool runSlice() final;
+
+        JUCE_DECLARE_NON_COPYABLE (Job)
+    };
+
+    /** Adds a task to this pool. The task must not already be part of a pool. */
+    void addTask (Task& task);
+
+    /**
+     * Removes a task from the pool, cancelling it if it's queued, and waiting for it
+     * if it's running. This should be called before anything that the task uses is
+     * destroyed.
+     */
+    void removeTask (Task& task);
+
+    /** Adds a job to this pool. The job must not already be part of a pool. */
+    void addJob (Job& job) { addTask (job); }
+
+    /**
+     * Removes a job from the pool, waiting for it to finish if it's running. This should
+     * be called before anything that the job uses is destroyed.
+     */
+    void removeJob (Job& job) { removeTask (job); }
+
+    /** Returns the number of worker threads in this pool. */
+    [[nodiscard]] int getNumThreads() const noexcept { return (int) threads.size(); }
+
+    /** Returns the number of tasks and jobs that are waiting for a worker. */
+    [[nodiscard]] int getQueueDepth() const noexcept { return queueDepth.load(); }
+
+    /** Returns true if any tasks or jobs are waiting for a worker, or running on one. */
+    [[nodiscard]] bool isBusy() const noexcept { return getQueueDepth() > 0 || numRunningTasks.load() > 0; }
+
+    /**
+     * Returns the time between the most recent task being queued (or job being requested)
+     * and a worker finishing it, in milliseconds.
+     */
+    [[nodiscard]] double getLastLatencyMs() const noexcept { return lastLatencyMs.load(); }
+
+    /** Returns the longest time between a task being queued (or job being requested) and a worker finishing it, in milliseconds. */
+    [[nodiscard]] double getMaxLatencyMs() const noexcept { return maxLatencyMs.load(); }
+
+    /** Resets the latency measurements. */
+    void resetLatencyStats() noexcept;
+
+    /**
+     * Holds the latest value of some parameters, which can be written from one thread,
+     * and read from a job. Only the most recently written value is ever read.
+     */
+    template <typename ParamsType>
+    class LatestParameters
+    {
+    public:
+        /** Writes a new value (only call this from one thread at a time). */
+        void write (const ParamsType& newParams) noexcept
+        {
+            slots[writeSlot] = newParams;
+            writeSlot = publishedSlot.exchange (writeSlot | newValueFlag, std::memory_order_acq_rel) & ~newValueFlag;
+        }
+
+        /** Returns true if a new value has been written since the last read. */
+        [[nodiscard]] bool hasNewValue() const noexcept
+        {
+            return (publishedSlot.load (std::memory_order_acquire) & newValueFlag) != 0;
+        }
+
+        /** Reads the latest value, if a new one has been written since the last read. */
+        bool read (ParamsType& params) noexcept
+        {
+            if (! hasNewValue())
+                return false;
+
+            readSlot = publishedSlot.exchange (readSlot, std::memory_order_acq_rel) & ~newValueFlag;
+            params = slots[readSlot];
+            return true;
+        }
+
+    private:
+        // Triple-buffered (like IRTransfer), so neither side ever waits on the other
+        std::array<ParamsType, 3> slots {};
+        static constexpr size_t newValueFlag = 4;
+        size_t writeSlot = 0, readSlot = 1;
+        std::atomic<size_t> publishedSlot { 2 };
+    };
+
+private:
+    struct WorkerThread : juce::Thread
+    {
+        explicit WorkerThread (ConvolutionWorkerPool& p) : juce::Thread ("Convolution Worker"), pool (p) {}
+        void run() override;
+        ConvolutionWorkerPool& pool;
+    };
+
+    static void requestRun (Task& task) noexcept;
+    Task* claimMostUrgentTask (double& requestTimeMs);
+    void finishSlice (Task& task, bool isFinished, double requestTimeMs);
+
+    void wakeUpWorker() noexcept;
+    void waitForWakeUp();
+
+    static int getDefaultNumThreads();
+
+    std::vector<std::unique_ptr<WorkerThread>> threads;
+
+    // The number of wake-ups that are waiting for a worker (at most one), or minus the
+    // number of workers that are asleep, waiting for a wake-up.
+    std::atomic<int> pendingWakeUps { 0 };
+    moodycamel::spsc_sema::Semaphore wakeUpSemaphore;
+
+    juce::CriticalSection tasksLock;
+    std::vector<Task*> tasks;
+    std::atomic<uint32_t> queueCounter { 0 };
+
+    // (a task is counted as queued before a worker can claim it, and as running until
+    // it's been put back, so isBusy() never misses anything)
+    std::atomic<int> queueDepth { 0 };
+    std::atomic<int> numRunningTasks { 0 };
+    std::atomic<double> lastLatencyMs { 0.0 }, maxLatencyMs { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionWorkerPool)
+};
+} // namespace chowdsp
@@ -2,8 +2,8 @@
 
 namespace chowdsp::IRHelpers
 {
-template <typename TransformFunc>
-void transformIRFreqDomain (float* targetIR, const float* originalIR, int numSamples, const juce::dsp::FFT& fft, TransformFunc&& transformer, bool removeDCBias, bool normalizeRMS)
+template <typename FFTType, typename TransformFunc>
+void transformIRFreqDomain (float* targetIR, const float* originalIR, int numSamples, const FFTType& fft, TransformFunc&& transformer, bool removeDCBias, bool normalizeRMS)
 {
     // The FFT object is initialized for the wrong size IR!
     jassert (fft.getSize() == numSamples);
@@ -39,7 +39,8 @@ void transformIRFreqDomain (float* targetIR, const float* originalIR, int numSam
     }
 }
 
-void makeLinearPhase (float* linearPhaseIR, const float* originalIR, int numSamples, const juce::dsp::FFT& fft)
+template <typename FFTType>
+void makeLinearPhase (float* linearPhaseIR, const float* originalIR, int numSamples, const FFTType& fft)
 {
     // @TODO: make sure all four types are handled correctly (even/symmetric, odd/symmetric, even/asym, odd/asym), plus add options for symmetric
 
@@ -72,7 +73,8 @@ void makeLinearPhase (float* linearPhaseIR, const float* originalIR, int numSamp
         true);
 }
 
-void makeMinimumPhase (float* minimumPhaseIR, const float* originalIR, int numSamples, const juce::dsp::FFT& fft)
+template <typename FFTType>
+void makeMinimumPhase (float* minimumPhaseIR, const float* originalIR, int numSamples, const FFTType& fft)
 {
     transformIRFreqDomain (
         minimumPhaseIR,
@@ -145,7 +147,8 @@ void makeMinimumPhase (float* minimumPhaseIR, const float* originalIR, int numSa
         false);
 }
 
-void makeHalfMagnitude (float* halfMagIR, const float* originalIR, int numSamples, const juce::dsp::FFT& fft)
+template <typename FFTType>
+void makeHalfMagnitude (float* halfMagIR, const float* originalIR, int numSamples, const FFTType& fft)
 {
     transformIRFreqDomain (
         halfMagIR,
@@ -13,9 +13,10 @@ namespace IRHelpers
      * @param linearPhaseIR     A "destination" pointer to the linear phase IR data
      * @param originalIR        A "source" pointer to the original IR data
      * @param numSamples        The length of the impulse response in samples
-     * @param fft               A shared FFT object to use for the computation
+     * @param fft               A shared FFT object to use for the computation (e.g. juce::dsp::FFT or chowdsp::SIMDFFT)
      */
-    void makeLinearPhase (float* linearPhaseIR, const float* originalIR, int numSamples, const juce::dsp::FFT& fft);
+    template <typename FFTType>
+    void makeLinearPhase (float* linearPhaseIR, const float* originalIR, int numSamples, const FFTType& fft);
 
     /**
      * Transforms an impulse response into a minimum phase impulse response
@@ -25,9 +26,10 @@ namespace IRHelpers
      * @param minimumPhaseIR    A "destination" pointer to the minimum phase IR data
      * @param originalIR        A "source" pointer to the original IR data
      * @param numSamples        The length of the impulse response in samples
-     * @param fft               A shared FFT object to use for the computation
+     * @param fft               A shared FFT object to use for the computation (e.g. juce::dsp::FFT or chowdsp::SIMDFFT)
      */
-    void makeMinimumPhase (float* minimumPhaseIR, const float* originalIR, int numSamples, const juce::dsp::FFT& fft);
+    template <typename FFTType>
+    void makeMinimumPhase (float* minimumPhaseIR, const float* originalIR, int numSamples, const FFTType& fft);
 
     /**
      * Transforms an impulse response to have exactly half the magnitude response of the original.
@@ -39,9 +41,12 @@ namespace IRHelpers
      * @param halfMagIR     A "destination" pointer to the half magnitude IR data
      * @param originalIR    A "source" pointer to the original IR data
      * @param numSamples    The length of the impulse response in samples
-     * @param fft           A shared FFT object to use for the computation
+     * @param fft           A shared FFT object to use for the computation (e.g. juce::dsp::FFT or chowdsp::SIMDFFT)
      */
-    void makeHalfMagnitude (float* halfMagIR, const float* originalIR, int numSamples, const juce::dsp::FFT& fft);
+    template <typename FFTType>
+    void makeHalfMagnitude (float* halfMagIR, const float* originalIR, int numSamples, const FFTType& fft);
 
 } // namespace IRHelpers
 } // namespace chowdsp
+
+#include "chowdsp_IRHelpers.cpp"
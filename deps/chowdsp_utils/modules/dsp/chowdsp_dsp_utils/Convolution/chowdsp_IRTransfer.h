@@ -7,6 +7,13 @@ namespace chowdsp
 /** A utility class to help smoothly transfer a new IR
  *  into a ConvolutionEngine in a thread-safe manner.
  * 
+ *  The IR spectra are computed by setNewIR() on a background
+ *  thread, into one of three pre-allocated banks, so neither
+ *  side ever waits on the other, or allocates. transferIR()
+ *  then starts the engines crossfading to the latest IR, over
+ *  `numCrossfadeBlocks` of the engine's blocks (which doubles
+ *  their cost while it lasts, see ConvolutionEngine::crossfadeToIR()).
+ *
  *  Note that the the size of every IR transferred via
  *  via this class MUST be the same size as the IR in
  *  ConvolutionEngine that was passed to the constructor.
@@ -14,21 +21,21 @@ namespace chowdsp
 struct IRTransfer
 {
     // create a new IRTransfer object for a given convolution engine
-    explicit IRTransfer (const ConvolutionEngine<>& eng) : fftSize (eng.fftSize),
-                                                           blockSize (eng.blockSize),
-                                                           irNumSamples (eng.irNumSamples),
-                                                           irFFT (std::make_unique<juce::dsp::FFT> (Math::log2 (fftSize)))
+    explicit IRTransfer (const ConvolutionEngine<>& eng, size_t numBlocksToCrossfade = 4) : fftSize (eng.fftSize),
+                                                                                          blockSize (eng.blockSize),
+                                                                                          irNumSamples (eng.irNumSamples),
+                                                                                          irFFT (std::make_unique<DefaultFFT> (Math::log2 (fftSize))),
+                                                                                          numCrossfadeBlocks (numBlocksToCrossfade)
     {
-        ConvolutionEngine<>::updateSegmentsIfNecessary (eng.numSegments, buffersImpulseSegments, fftSize);
+        for (auto& bank : banks)
+            ConvolutionEngine<>::updateSegmentsIfNecessary (eng.numSegments, bank, fftSize);
     }
 
-    // loads a new IR to be ready for transferring
+    // loads a new IR to be ready for transferring (only call this from one thread at a time)
     void setNewIR (const float* newIR)
     {
-        juce::SpinLock::ScopedLockType lock (mutex);
-
         size_t currentPtr = 0;
-        for (auto& buf : buffersImpulseSegments)
+        for (auto& buf : banks[writeBank])
         {
             buf.clear();
             auto* impulseResponse = buf.getWritePointer (0);
@@ -42,28 +49,61 @@ struct IRTransfer
 
             currentPtr += (fftSize - blockSize);
         }
+
+        // publish the new bank, and take back whichever one was published before
+        writeBank = publishedBank.exchange (writeBank | newIRFlag, std::memory_order_acq_rel) & ~newIRFlag;
     }
 
-    // transfers the loaded IR to a convolution engine
-    void transferIR (ConvolutionEngine<>& engine) const
+    // returns true if a new IR has been loaded since the last transfer
+    [[nodiscard]] bool hasNewIR() const noexcept
     {
-        for (size_t i = 0; i < buffersImpulseSegments.size(); ++i)
-        {
-            auto& sourceBuffer = buffersImpulseSegments[i];
-            auto& destBuffer = engine.buffersImpulseSegments[i];
+        return (publishedBank.load (std::memory_order_acquire) & newIRFlag) != 0;
+    }
 
-            juce::FloatVectorOperations::copy (destBuffer.getWritePointer (0),
-                                               sourceBuffer.getReadPointer (0),
-                                               sourceBuffer.getNumSamples());
-        }
+    /**
+     * Starts crossfading a group of engines (e.g. one per channel) to the latest IR.
+     * The engines can be passed as a container of pointers (or smart pointers).
+     *
+     * Returns false if there's no new IR, or if the engines are still crossfading
+     * to the previous one, in which case the transfer should be tried again later.
+     */
+    template <typename EngineList>
+    bool transferIR (const EngineList& engines)
+    {
+        if (! hasNewIR())
+            return false;
+
+        for (const auto& eng : engines)
+            if (eng->isCrossfading())
+                return false;
+
+        readBank = publishedBank.exchange (readBank, std::memory_order_acq_rel) & ~newIRFlag;
+
+        for (const auto& eng : engines)
+            eng->crossfadeToIR (banks[readBank], numCrossfadeBlocks);
+
+        return true;
+    }
+
+    // starts crossfading a single engine to the latest IR
+    bool transferIR (ConvolutionEngine<>& engine)
+    {
+        return transferIR (std::array<ConvolutionEngine<>*, 1> { &engine });
     }
 
     const size_t fftSize;
     const size_t blockSize;
     const size_t irNumSamples;
-    const std::unique_ptr<juce::dsp::FFT> irFFT;
-    std::vector<juce::AudioBuffer<float>> buffersImpulseSegments;
-    juce::SpinLock mutex;
+    const std::unique_ptr<DefaultFFT> irFFT;
+    size_t numCrossfadeBlocks;
+
+private:
+    // Triple-buffered: the background thread writes one bank, the audio thread
+    // reads another, and the third holds the most recently published IR.
+    std::array<std::vector<juce::AudioBuffer<float>>, 3> banks;
+    static constexpr size_t newIRFlag = 4;
+    size_t writeBank = 0, readBank = 1;
+    std::atomic<size_t> publishedBank { 2 };
 };
 
 } // namespace chowdsp
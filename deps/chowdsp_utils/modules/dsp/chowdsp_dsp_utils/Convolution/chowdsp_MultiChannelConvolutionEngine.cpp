@@ -0,0 +1,298 @@
+#include "chowdsp_MultiChannelConvolutionEngine.h"
+
+namespace chowdsp
+{
+template <typename FFTEngineType>
+std::vector<typename MultiChannelConvolutionEngine<FFTEngineType>::Route> MultiChannelConvolutionEngine<FFTEngineType>::getParallelRoutes (size_t numChannels)
+{
+    std::vector<Route> parallelRoutes;
+    for (size_t ch = 0; ch < numChannels; ++ch)
+        parallelRoutes.push_back ({ ch, ch, 0 });
+    return parallelRoutes;
+}
+
+template <typename FFTEngineType>
+std::vector<typename MultiChannelConvolutionEngine<FFTEngineType>::Route> MultiChannelConvolutionEngine<FFTEngineType>::getTrueStereoRoutes()
+{
+    return { { 0, 0, 0 }, { 1, 0, 1 }, { 0, 1, 2 }, { 1, 1, 3 } };
+}
+
+#ifndef DOXYGEN
+namespace MultiChannelConvolutionDetail
+{
+    template <typename Route>
+    std::vector<Route> sortRoutesByIR (std::vector<Route>&& routes)
+    {
+        std::stable_sort (routes.begin(), routes.end(), [] (const Route& a, const Route& b)
+                          { return a.irIndex < b.irIndex; });
+        return std::move (routes);
+    }
+
+    template <typename Route>
+    size_t getNumIRs (const std::vector<Route>& routes)
+    {
+        size_t numIRs = 0;
+        for (const auto& route : routes)
+            numIRs = juce::jmax (numIRs, route.irIndex + 1);
+        return numIRs;
+    }
+} // namespace MultiChannelConvolutionDetail
+#endif
+
+template <typename FFTEngineType>
+MultiChannelConvolutionEngine<FFTEngineType>::MultiChannelConvolutionEngine (size_t numSamples,
+                                                                             size_t maxBlockSize,
+                                                                             size_t numInputs,
+                                                                             size_t numOutputs,
+                                                                             std::vector<Route> newRoutes)
+    : irNumSamples (numSamples),
+      numInputChannels (numInputs),
+      numOutputChannels (numOutputs),
+      blockSize ((size_t) juce::nextPowerOfTwo ((int) maxBlockSize)),
+      fftSize (2 * blockSize),
+      numBins (blockSize + 1),
+      numSegments (juce::jmax ((size_t) 1, (numSamples + blockSize - 1) / blockSize)),
+      routes (MultiChannelConvolutionDetail::sortRoutesByIR (std::move (newRoutes))),
+      fftObject (std::make_unique<FFTEngineType> (Math::log2 (fftSize)))
+{
+    for ([[maybe_unused]] const auto& route : routes)
+        jassert (route.inputChannel < numInputChannels && route.outputChannel < numOutputChannels);
+
+    inputData.resize (numInputChannels, std::vector<float> (fftSize, 0.0f));
+    inputSegments.resize (numInputChannels, std::vector<float> (2 * numBins * numSegments, 0.0f));
+    irSpectra.resize (MultiChannelConvolutionDetail::getNumIRs (routes), std::vector<float> (2 * numBins * numSegments, 0.0f));
+    pastSegmentsAccumulator.resize (2 * numBins * numOutputChannels, 0.0f);
+    outputSpectra.resize (2 * numBins * numOutputChannels, 0.0f);
+    outputData.resize (numOutputChannels, std::vector<float> (fftSize, 0.0f));
+    overlapData.resize (numOutputChannels, std::vector<float> (blockSize, 0.0f));
+
+    fftInput.resize (fftSize);
+    fftOutput.resize (fftSize);
+
+    reset();
+}
+
+template <typename FFTEngineType>
+void MultiChannelConvolutionEngine<FFTEngineType>::reset()
+{
+    const auto clear = [] (auto& buffers)
+    {
+        for (auto& buffer : buffers)
+            std::fill (buffer.begin(), buffer.end(), 0.0f);
+    };
+    clear (inputData);
+    clear (inputSegments);
+    clear (outputData);
+    clear (overlapData);
+
+    currentSegment = 0;
+    inputDataPos = 0;
+}
+
+template <typename FFTEngineType>
+void MultiChannelConvolutionEngine<FFTEngineType>::setNewIR (size_t irIndex, const float* newIR)
+{
+    jassert (irIndex < irSpectra.size());
+    auto& spectra = irSpectra[irIndex];
+
+    for (size_t segment = 0; segment < numSegments; ++segment)
+    {
+        const auto segmentStart = segment * blockSize;
+        const auto segmentLength = juce::jmin (blockSize, irNumSamples - segmentStart);
+
+        std::fill (fftInput.begin(), fftInput.end(), std::complex<float> {});
+        for (size_t n = 0; n < segmentLength; ++n)
+            fftInput[n] = newIR[segmentStart + n];
+
+        fftObject->perform (fftInput.data(), fftOutput.data(), false);
+
+        auto* re = getRealPart (spectra, segment);
+        auto* im = getImagPart (spectra, segment);
+        for (size_t k = 0; k < numBins; ++k)
+        {
+            re[k] = fftOutput[k].real();
+            im[k] = fftOutput[k].imag();
+        }
+    }
+}
+
+template <typename FFTEngineType>
+void MultiChannelConvolutionEngine<FFTEngineType>::forwardTransformInputs()
+{
+    // Two real channels, a and b, go through one complex FFT as z = a + jb. Then,
+    // since A and B are conjugate-symmetric, A[k] = (Z[k] + Z*[N-k]) / 2 and
+    // B[k] = (Z[k] - Z*[N-k]) / 2j.
+    for (size_t ch = 0; ch < numInputChannels; ch += 2)
+    {
+        const auto* a = inputData[ch].data();
+        const auto* b = ch + 1 < numInputChannels ? inputData[ch + 1].data() : nullptr;
+
+        for (size_t n = 0; n < fftSize; ++n)
+            fftInput[n] = { a[n], b != nullptr ? b[n] : 0.0f };
+
+        fftObject->perform (fftInput.data(), fftOutput.data(), false);
+
+        auto* aRe = getRealPart (inputSegments[ch], currentSegment);
+        auto* aIm = getImagPart (inputSegments[ch], currentSegment);
+        for (size_t k = 0; k < numBins; ++k)
+        {
+            const auto z = fftOutput[k];
+            const auto zMirror = std::conj (fftOutput[(fftSize - k) & (fftSize - 1)]);
+            aRe[k] = 0.5f * (z.real() + zMirror.real());
+            aIm[k] = 0.5f * (z.imag() + zMirror.imag());
+        }
+
+        if (b == nullptr)
+            continue;
+
+        auto* bRe = getRealPart (inputSegments[ch + 1], currentSegment);
+        auto* bIm = getImagPart (inputSegments[ch + 1], currentSegment);
+        for (size_t k = 0; k < numBins; ++k)
+        {
+            const auto z = fftOutput[k];
+            const auto zMirror = std::conj (fftOutput[(fftSize - k) & (fftSize - 1)]);
+            bRe[k] = 0.5f * (z.imag() - zMirror.imag());
+            bIm[k] = -0.5f * (z.real() - zMirror.real());
+        }
+    }
+}
+
+template <typename FFTEngineType>
+void MultiChannelConvolutionEngine<FFTEngineType>::inverseTransformOutputs()
+{
+    // The reverse of forwardTransformInputs(): the full spectrum of c + jd is
+    // C[k] + jD[k], with the upper half filled in from the conjugate symmetry
+    // of C and D, so one inverse FFT gives c in the real part and d in the
+    // imaginary part.
+    for (size_t ch = 0; ch < numOutputChannels; ch += 2)
+    {
+        const auto* cRe = getRealPart (outputSpectra, ch);
+        const auto* cIm = getImagPart (outputSpectra, ch);
+        const auto hasPair = ch + 1 < numOutputChannels;
+        const auto* dRe = hasPair ? getRealPart (outputSpectra, ch + 1) : nullptr;
+        const auto* dIm = hasPair ? getImagPart (outputSpectra, ch + 1) : nullptr;
+
+        for (size_t k = 0; k < numBins; ++k)
+        {
+            fftInput[k] = hasPair ? std::complex<float> { cRe[k] - dIm[k], cIm[k] + dRe[k] }
+                                  : std::complex<float> { cRe[k], cIm[k] };
+        }
+        for (size_t k = numBins; k < fftSize; ++k)
+        {
+            const auto m = fftSize - k;
+            fftInput[k] = hasPair ? std::complex<float> { cRe[m] + dIm[m], dRe[m] - cIm[m] }
+                                  : std::complex<float> { cRe[m], -cIm[m] };
+        }
+
+        fftObject->perform (fftInput.data(), fftOutput.data(), true);
+
+        auto* c = outputData[ch].data();
+        for (size_t n = 0; n < fftSize; ++n)
+            c[n] = fftOutput[n].real();
+
+        if (! hasPair)
+            continue;
+
+        auto* d = outputData[ch + 1].data();
+        for (size_t n = 0; n < fftSize; ++n)
+            d[n] = fftOutput[n].imag();
+    }
+}
+
+template <typename FFTEngineType>
+void MultiChannelConvolutionEngine<FFTEngineType>::complexMultiplyAccumulate (float* outRe, float* outIm, const float* aRe, const float* aIm, const float* bRe, const float* bIm, int numBinsToProcess) noexcept
+{
+    juce::FloatVectorOperations::addWithMultiply (outRe, aRe, bRe, numBinsToProcess);
+    juce::FloatVectorOperations::subtractWithMultiply (outRe, aIm, bIm, numBinsToProcess);
+    juce::FloatVectorOperations::addWithMultiply (outIm, aRe, bIm, numBinsToProcess);
+    juce::FloatVectorOperations::addWithMultiply (outIm, aIm, bRe, numBinsToProcess);
+}
+
+template <typename FFTEngineType>
+void MultiChannelConvolutionEngine<FFTEngineType>::accumulatePastSegments()
+{
+    std::fill (pastSegmentsAccumulator.begin(), pastSegmentsAccumulator.end(), 0.0f);
+
+    // Segment-major, so that every route using an IR partition (the routes
+    // are sorted by IR) goes through it while it is still in the cache.
+    for (size_t segment = 1; segment < numSegments; ++segment)
+    {
+        const auto inputIndex = (currentSegment + segment) % numSegments;
+        for (const auto& route : routes)
+        {
+            auto& inputSpectra = inputSegments[route.inputChannel];
+            auto& impulseSpectra = irSpectra[route.irIndex];
+            complexMultiplyAccumulate (getRealPart (pastSegmentsAccumulator, route.outputChannel),
+                                       getImagPart (pastSegmentsAccumulator, route.outputChannel),
+                                       getRealPart (inputSpectra, inputIndex),
+                                       getImagPart (inputSpectra, inputIndex),
+                                       getRealPart (impulseSpectra, segment),
+                                       getImagPart (impulseSpectra, segment),
+                                       (int) numBins);
+        }
+    }
+}
+
+template <typename FFTEngineType>
+void MultiChannelConvolutionEngine<FFTEngineType>::processSamples (const float* const* input, float* const* output, size_t numSamples)
+{
+    // Overlap-add, zero latency convolution algorithm with uniform partitioning
+    size_t numSamplesProcessed = 0;
+    while (numSamplesProcessed < numSamples)
+    {
+        const bool inputDataWasEmpty = (inputDataPos == 0);
+        const auto numSamplesToProcess = juce::jmin (numSamples - numSamplesProcessed, blockSize - inputDataPos);
+
+        // every input is copied before any output is written, so processing in-place is fine
+        for (size_t ch = 0; ch < numInputChannels; ++ch)
+            juce::FloatVectorOperations::copy (inputData[ch].data() + inputDataPos, input[ch] + numSamplesProcessed, (int) numSamplesToProcess);
+
+        forwardTransformInputs();
+
+        // the older segments only change once per block
+        if (inputDataWasEmpty)
+            accumulatePastSegments();
+
+        std::copy (pastSegmentsAccumulator.begin(), pastSegmentsAccumulator.end(), outputSpectra.begin());
+        for (const auto& route : routes)
+        {
+            auto& inputSpectra = inputSegments[route.inputChannel];
+            auto& impulseSpectra = irSpectra[route.irIndex];
+            complexMultiplyAccumulate (getRealPart (outputSpectra, route.outputChannel),
+                                       getImagPart (outputSpectra, route.outputChannel),
+                                       getRealPart (inputSpectra, currentSegment),
+                                       getImagPart (inputSpectra, currentSegment),
+                                       getRealPart (impulseSpectra, 0),
+                                       getImagPart (impulseSpectra, 0),
+                                       (int) numBins);
+        }
+
+        inverseTransformOutputs();
+
+        // Add overlap
+        for (size_t ch = 0; ch < numOutputChannels; ++ch)
+        {
+            juce::FloatVectorOperations::add (output[ch] + numSamplesProcessed,
+                                              outputData[ch].data() + inputDataPos,
+                                              overlapData[ch].data() + inputDataPos,
+                                              (int) numSamplesToProcess);
+        }
+
+        // Input buffer full => Next block
+        inputDataPos += numSamplesToProcess;
+        if (inputDataPos == blockSize)
+        {
+            for (auto& data : inputData)
+                std::fill (data.begin(), data.begin() + (int) blockSize, 0.0f);
+
+            for (size_t ch = 0; ch < numOutputChannels; ++ch)
+                juce::FloatVectorOperations::copy (overlapData[ch].data(), outputData[ch].data() + blockSize, (int) blockSize);
+
+            inputDataPos = 0;
+            currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numSegments - 1);
+        }
+
+        numSamplesProcessed += numSamplesToProcess;
+    }
+}
+} // namespace chowdsp
@@ -0,0 +1,289 @@
+#include "chowdsp_NonUniformConvolutionEngine.h"
+
+namespace chowdsp
+{
+#ifndef DOXYGEN
+namespace NonUniformConvolutionDetail
+{
+    /** The head covers the first four block-sized partitions, or the whole IR if the tail can't start after that. */
+    inline size_t getHeadNumSamples (size_t irNumSamples, size_t blockSize, size_t maxPartitionSize)
+    {
+        if (2 * blockSize > maxPartitionSize)
+            return irNumSamples;
+        return juce::jmin (irNumSamples, 4 * blockSize);
+    }
+} // namespace NonUniformConvolutionDetail
+#endif
+
+template <typename FFTEngineType>
+NonUniformConvolutionEngine<FFTEngineType>::TailStage::TailStage (size_t numPartitionSamples, size_t offset, size_t length)
+    : partitionSize (numPartitionSamples),
+      irOffset (offset),
+      irLength (length),
+      engine (length, numPartitionSamples),
+      segmentsPerSlice (juce::jmax ((size_t) 1, maxBinsPerSlice / (engine.fftSize / 2)))
+{
+    for (auto* partition : { &audioInput, &audioOutput, &taskInput, &taskOutput })
+        partition->resize (partitionSize, 0.0f);
+}
+
+template <typename FFTEngineType>
+void NonUniformConvolutionEngine<FFTEngineType>::TailStage::reset()
+{
+    engine.reset();
+
+    for (auto* partition : { &audioInput, &audioOutput, &taskInput, &taskOutput })
+        std::fill (partition->begin(), partition->end(), 0.0f);
+
+    partitionPos = 0;
+    nextSegment = 0;
+    needsResync = false;
+    resetBeforeTask = false;
+}
+
+template <typename FFTEngineType>
+bool NonUniformConvolutionEngine<FFTEngineType>::TailStage::runSlice()
+{
+    // This is ConvolutionEngine::processSamples() for one full block, split up.
+    auto* inputSegmentData = engine.buffersInputSegments[engine.currentSegment].getWritePointer (0);
+    auto* outputTempData = engine.bufferTempOutput.getWritePointer (0);
+
+    if (nextSegment == 0)
+    {
+        if (resetBeforeTask)
+        {
+            engine.reset();
+            resetBeforeTask = false;
+        }
+
+        juce::FloatVectorOperations::copy (inputSegmentData, taskInput.data(), (int) partitionSize);
+        juce::FloatVectorOperations::fill (inputSegmentData + partitionSize, 0.0f, (int) (engine.fftSize - partitionSize));
+        engine.fftObject->performRealOnlyForwardTransform (inputSegmentData);
+        engine.prepareForConvolution (inputSegmentData, engine.fftSize);
+
+        juce::FloatVectorOperations::fill (outputTempData, 0.0f, (int) engine.fftSize + 1);
+        nextSegment = 1;
+        return false;
+    }
+
+    if (nextSegment < engine.numSegments)
+    {
+        const auto endSegment = juce::jmin (nextSegment + segmentsPerSlice, engine.numSegments);
+        engine.accumulateSegments (engine.buffersImpulseSegments, outputTempData, nextSegment, endSegment);
+        nextSegment = endSegment;
+        return false;
+    }
+
+    auto* outputData = engine.bufferOutput.getWritePointer (0);
+    auto* overlapData = engine.bufferOverlap.getWritePointer (0);
+    engine.computeOutput (inputSegmentData, engine.buffersImpulseSegments, outputTempData, outputData);
+    juce::FloatVectorOperations::add (taskOutput.data(), outputData, overlapData, (int) partitionSize);
+
+    engine.saveOverlap (outputData, overlapData);
+    engine.currentSegment = (engine.currentSegment > 0) ? (engine.currentSegment - 1) : (engine.numInputSegments - 1);
+
+    nextSegment = 0;
+    return true;
+}
+
+template <typename FFTEngineType>
+NonUniformConvolutionEngine<FFTEngineType>::NonUniformConvolutionEngine (size_t numSamples,
+                                                                         size_t maxBlockSize,
+                                                                         const float* initialIR,
+                                                                         size_t maxPartitionSize,
+                                                                         bool useBackgroundThread)
+    : irNumSamples (numSamples),
+      blockSize ((size_t) juce::nextPowerOfTwo ((int) maxBlockSize)),
+      headNumSamples (NonUniformConvolutionDetail::getHeadNumSamples (numSamples, blockSize, maxPartitionSize)),
+      headEngine (headNumSamples, blockSize)
+{
+    // each stage starts two of its partitions into the IR, and covers two
+    // partitions, so the next stage can start two (doubled) partitions in
+    size_t irOffset = headNumSamples;
+    for (auto partitionSize = 2 * blockSize; irOffset < irNumSamples; partitionSize *= 2)
+    {
+        const auto isLastStage = partitionSize >= maxPartitionSize;
+        const auto irLength = isLastStage ? irNumSamples - irOffset : juce::jmin (2 * partitionSize, irNumSamples - irOffset);
+
+        tailStages.push_back (std::make_unique<TailStage> (partitionSize, irOffset, irLength));
+        irOffset += irLength;
+    }
+
+    tailOutput.resize (blockSize, 0.0f);
+
+    if (initialIR != nullptr)
+        setNewIR (initialIR);
+
+    if (useBackgroundThread && ! tailStages.empty())
+    {
+        workerPool = std::make_unique<juce::SharedResourcePointer<ConvolutionWorkerPool>>();
+        for (auto& stage : tailStages)
+            (*workerPool)->addTask (*stage);
+    }
+}
+
+template <typename FFTEngineType>
+NonUniformConvolutionEngine<FFTEngineType>::~NonUniformConvolutionEngine()
+{
+    if (workerPool != nullptr)
+    {
+        for (auto& stage : tailStages)
+            (*workerPool)->removeTask (*stage);
+    }
+}
+
+template <typename FFTEngineType>
+void NonUniformConvolutionEngine<FFTEngineType>::cancelTailStageTasks()
+{
+    for (auto& stage : tailStages)
+        stage->cancel();
+}
+
+template <typename FFTEngineType>
+void NonUniformConvolutionEngine<FFTEngineType>::reset()
+{
+    cancelTailStageTasks();
+
+    headEngine.reset();
+    for (auto& stage : tailStages)
+        stage->reset();
+}
+
+template <typename FFTEngineType>
+void NonUniformConvolutionEngine<FFTEngineType>::setNewIR (const float* newIR)
+{
+    // the stages keep their history, so any partitions in flight are finished with the old IR
+    for (auto& stage : tailStages)
+        finishTailStageTask (*stage, true);
+
+    headEngine.setNewIR (newIR);
+    for (auto& stage : tailStages)
+        stage->engine.setNewIR (newIR + stage->irOffset);
+}
+
+template <typename FFTEngineType>
+typename NonUniformConvolutionEngine<FFTEngineType>::TaskResult NonUniformConvolutionEngine<FFTEngineType>::finishTailStageTask (TailStage& stage, bool canWaitForWorkers)
+{
+    while (! stage.isFinished())
+    {
+        if (stage.tryClaim())
+        {
+            // The workers haven't got to this one in time, so it's finished here
+            // (unless its result is going to be thrown away anyway).
+            const auto isDropped = stage.needsResync;
+            if (! isDropped)
+            {
+                while (! stage.runSlice())
+                {
+                }
+            }
+
+            stage.release();
+            return isDropped ? TaskResult::Finished : TaskResult::FinishedHere;
+        }
+
+        // Otherwise a worker is in the middle of one of this stage's slices
+        if (! canWaitForWorkers)
+            return TaskResult::Missed;
+
+        juce::Thread::yield();
+    }
+
+    return TaskResult::Finished;
+}
+
+template <typename FFTEngineType>
+void NonUniformConvolutionEngine<FFTEngineType>::startTailStagePartition (TailStage& stage)
+{
+    const auto taskResult = finishTailStageTask (stage, nonRealtime);
+    if (taskResult == TaskResult::Missed)
+    {
+        // The stage has missed its deadline: it's silent for the next partition, and
+        // the input partition that has just been collected is dropped. Once the late
+        // result comes in, it's thrown away, and the stage starts again from silence.
+        numMissedTailResults.fetch_add (1, std::memory_order_relaxed);
+        std::fill (stage.audioOutput.begin(), stage.audioOutput.end(), 0.0f);
+        stage.needsResync = true;
+        return;
+    }
+
+    if (taskResult == TaskResult::FinishedHere && workerPool != nullptr)
+        numLateTailResults.fetch_add (1, std::memory_order_relaxed);
+
+    // The previous partition's result is read out over the next partition,
+    // while this one is computed.
+    std::swap (stage.audioInput, stage.taskInput);
+    std::swap (stage.audioOutput, stage.taskOutput);
+
+    if (stage.needsResync)
+    {
+        std::fill (stage.audioOutput.begin(), stage.audioOutput.end(), 0.0f);
+        stage.resetBeforeTask = true;
+        stage.needsResync = false;
+    }
+
+    stage.nextSegment = 0;
+    if (workerPool != nullptr)
+    {
+        // the result is needed once the next partition has been collected
+        stage.queue (1000.0 * (double) stage.partitionSize / sampleRate);
+    }
+    else
+    {
+        while (! stage.runSlice())
+        {
+        }
+    }
+}
+
+template <typename FFTEngineType>
+void NonUniformConvolutionEngine<FFTEngineType>::processTailStage (TailStage& stage, const float* input, float* output, size_t numSamples)
+{
+    // The stage's output for an input partition is delayed by two partitions
+    // (since that's where the stage starts in the IR), which is one partition
+    // for the input to fill up, and one for it to be computed.
+    size_t numSamplesProcessed = 0;
+    while (numSamplesProcessed < numSamples)
+    {
+        const auto numSamplesToProcess = juce::jmin (numSamples - numSamplesProcessed, stage.partitionSize - stage.partitionPos);
+
+        juce::FloatVectorOperations::copy (stage.audioInput.data() + stage.partitionPos,
+                                           input + numSamplesProcessed,
+                                           (int) numSamplesToProcess);
+        juce::FloatVectorOperations::add (output + numSamplesProcessed,
+                                          stage.audioOutput.data() + stage.partitionPos,
+                                          (int) numSamplesToProcess);
+
+        numSamplesProcessed += numSamplesToProcess;
+        stage.partitionPos += numSamplesToProcess;
+
+        if (stage.partitionPos == stage.partitionSize)
+        {
+            stage.partitionPos = 0;
+            startTailStagePartition (stage);
+        }
+    }
+}
+
+template <typename FFTEngineType>
+void NonUniformConvolutionEngine<FFTEngineType>::processSamples (const float* input, float* output, size_t numSamples)
+{
+    size_t numSamplesProcessed = 0;
+    while (numSamplesProcessed < numSamples)
+    {
+        const auto numSamplesToProcess = juce::jmin (numSamples - numSamplesProcessed, blockSize);
+        const auto* blockInput = input + numSamplesProcessed;
+        auto* blockOutput = output + numSamplesProcessed;
+
+        // the tail stages go first, since the head may process in-place
+        juce::FloatVectorOperations::fill (tailOutput.data(), 0.0f, (int) numSamplesToProcess);
+        for (auto& stage : tailStages)
+            processTailStage (*stage, blockInput, tailOutput.data(), numSamplesToProcess);
+
+        headEngine.processSamples (blockInput, blockOutput, numSamplesToProcess);
+        juce::FloatVectorOperations::add (blockOutput, tailOutput.data(), (int) numSamplesToProcess);
+
+        numSamplesProcessed += numSamplesToProcess;
+    }
+}
+} // namespace chowdsp
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "chowdsp_ConvolutionEngine.h"
+#include "chowdsp_ConvolutionWorkerPool.h"
+
+namespace chowdsp
+{
+/**
+ * A zero-latency convolution engine for long IRs, using non-uniform partitioning.
+ *
+ * The start of the IR (the "head") is run through a uniformly-partitioned
+ * ConvolutionEngine with partitions the size of the audio block, so there is
+ * no added latency. The rest of the IR is split into "tail" stages, where each
+ * stage's partitions are twice the size of the previous stage's, up to
+ * `maxPartitionSize`:
+ * ```
+ * | head: 4 x B | 2 x 2B | 2 x 4B | 2 x 8B | ... | n x maxPartitionSize |
+ * ```
+ * Each tail stage starts (at least) two of its own partitions into the IR, so
+ * once a stage has collected a partition's worth of input, its result isn't
+ * needed for another partition's worth of samples. That gives the stage's FFTs
+ * a whole partition period to run in the background, instead of landing on the
+ * audio thread all in one callback.
+ *
+ * The tail stages of every engine in the process are computed by one shared
+ * ConvolutionWorkerPool, in slices (the forward FFT, a few of the spectral
+ * multiplies at a time, then the inverse FFT), with the nearest deadline first,
+ * so a big stage can't hold up a small one for more than a slice. The audio thread never waits for the workers: if a stage's result
+ * isn't ready by the time it's needed, the audio thread finishes it itself
+ * (see getNumLateTailResults()), unless a worker is in the middle of one of its
+ * slices, in which case the stage misses that partition, and drops out for a
+ * couple of partitions while it starts again from silence (see
+ * getNumMissedTailResults()). For offline rendering with the workers, call
+ * setNonRealtime(), so that the audio thread waits for a slice in progress
+ * rather than missing it, and the output doesn't depend on thread timing.
+ *
+ * With `useBackgroundThread = false`, each tail stage is computed on the
+ * audio thread as soon as its partition is full.
+ * ```
+ * chowdsp::NonUniformConvolutionEngine<> engine { irSize, maxBlockSize, ir };
+ *
+ * // in audio callback:
+ * engine.processSamples (input, output, numSamples);
+ * ```
+ */
+template <typename FFTEngineType = DefaultFFT>
+class NonUniformConvolutionEngine
+{
+public:
+    /**
+     * Creates a new convolution engine for a given IR. Future IRs loaded into
+     * this engine must be the same size.
+     */
+    NonUniformConvolutionEngine (size_t numSamples,
+                                 size_t maxBlockSize,
+                                 const float* initialIR = nullptr,
+                                 size_t maxPartitionSize = 8192,
+                                 bool useBackgroundThread = true);
+
+    ~NonUniformConvolutionEngine();
+
+    /** Resets the state of the convolution. */
+    void reset();
+
+    /**
+     * Sets these samples as the new IR.
+     *
+     * This computes the IR spectra for every partition, so it must not be
+     * called while the engine is processing audio.
+     */
+    void setNewIR (const float* newIR);
+
+    /**
+     * Lets the audio thread wait for a tail stage's slice that a worker is in the
+     * middle of, rather than missing the stage's result. This is useful for offline
+     * rendering, where the output shouldn't depend on thread timing.
+     */
+    void setNonRealtime (bool isNonRealtime) noexcept { nonRealtime = isNonRealtime; }
+
+    /**
+     * Sets the sample rate that the engine is running at (48 kHz by default). The worker
+     * pool uses this to work out when each tail stage's result is due, relative to the
+     * other engines' stages.
+     */
+    void setSampleRate (double newSampleRate) noexcept { sampleRate = newSampleRate; }
+
+    /** Processes samples with zero latency. */
+    void processSamples (const float* input, float* output, size_t numSamples);
+
+    /** Returns the number of tail stages that the IR has been split into. */
+    [[nodiscard]] size_t getNumTailStages() const noexcept { return tailStages.size(); }
+
+    /** Returns the partition size of one of the tail stages. */
+    [[nodiscard]] size_t getTailPartitionSize (size_t stageIndex) const noexcept { return tailStages[stageIndex]->partitionSize; }
+
+    /**
+     * Returns the number of tail stage results that the workers hadn't got to by the
+     * time they were needed, so they were computed on the audio thread.
+     */
+    [[nodiscard]] size_t getNumLateTailResults() const noexcept { return numLateTailResults.load(); }
+
+    /**
+     * Returns the number of tail stage results that a worker was still in the middle of
+     * when they were needed, so that stage dropped out for a couple of partitions.
+     */
+    [[nodiscard]] size_t getNumMissedTailResults() const noexcept { return numMissedTailResults.load(); }
+
+    //==============================================================================
+    const size_t irNumSamples;
+    const size_t blockSize;
+    const size_t headNumSamples;
+
+private:
+    struct TailStage : ConvolutionWorkerPool::Task
+    {
+        TailStage (size_t partitionSize, size_t irOffset, size_t irLength);
+
+        void reset();
+        bool runSlice() override;
+
+        const size_t partitionSize;
+        const size_t irOffset;
+        const size_t irLength;
+        ConvolutionEngine<FFTEngineType> engine;
+
+        // Double-buffered: while the audio thread fills one input partition and
+        // reads out an output partition, the previous input partition is being
+        // convolved into the other output partition. The buffers are swapped
+        // when the audio thread hands over a partition.
+        std::vector<float> audioInput, audioOutput;
+        std::vector<float> taskInput, taskOutput;
+        size_t partitionPos = 0;
+
+        // Each task does the forward FFT, then the spectral multiplies for a few
+        // segments at a time, then the inverse FFT.
+        static constexpr size_t maxBinsPerSlice = 32768;
+        const size_t segmentsPerSlice;
+        size_t nextSegment = 0; // 0 until the forward FFT is done
+
+        // After a missed result, the stage's input history has a gap in it, so
+        // it's started again from silence.
+        bool needsResync = false;
+        bool resetBeforeTask = false;
+    };
+
+    void processTailStage (TailStage& stage, const float* input, float* output, size_t numSamples);
+    void startTailStagePartition (TailStage& stage);
+    enum class TaskResult
+    {
+        Finished,
+        FinishedHere, // by the calling thread, rather than a worker
+        Missed, // a worker is still running one of its slices
+    };
+    TaskResult finishTailStageTask (TailStage& stage, bool canWaitForWorkers);
+    void cancelTailStageTasks();
+
+    ConvolutionEngine<FFTEngineType> headEngine;
+    std::vector<std::unique_ptr<TailStage>> tailStages;
+    std::vector<float> tailOutput;
+
+    std::unique_ptr<juce::SharedResourcePointer<ConvolutionWorkerPool>> workerPool;
+    bool nonRealtime = false;
+    double sampleRate = 48000.0;
+    std::atomic<size_t> numLateTailResults { 0 }, numMissedTailResults { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NonUniformConvolutionEngine)
+};
+} // namespace chowdsp
+
+#include "chowdsp_NonUniformConvolutionEngine.cpp"
@@ -2,9 +2,14 @@
 
 namespace chowdsp
 {
-/** A processor similarto chowdsp::ThreeWayCrossoverFilter, but linear phase */
+/**
+ * A processor similar to chowdsp::ThreeWayCrossoverFilter, but linear phase.
+ *
+ * When the crossover frequencies change, the IRs are re-computed on the ConvolutionWorkerPool
+ * that's shared between all the convolution processors in the process.
+ */
 template <int Order>
-class LinearPhase3WayCrossover : private juce::HighResolutionTimer
+class LinearPhase3WayCrossover : private ConvolutionWorkerPool::Job
 {
 public:
     static_assert (Order > 2 && Order % 2 == 0, "This implementation only works with even filter orders greater than 2");
@@ -13,13 +18,15 @@ public:
 
     ~LinearPhase3WayCrossover() override
     {
-        stopTimer();
+        workerPool->removeJob (*this);
     }
 
     /** Prepares the crossover filter with an IR length and initial crossover frequencies */
     void prepare (const juce::dsp::ProcessSpec& spec, int irLength, float lowBandCrossoverHz, float highBandCrossoverHz)
     {
-        fft = std::make_unique<juce::dsp::FFT> (Math::log2 (irLength));
+        workerPool->removeJob (*this);
+
+        fft = std::make_unique<DefaultFFT> (Math::log2 (irLength));
         irSize = irLength;
 
         const auto protoSpec = juce::dsp::ProcessSpec { spec.sampleRate, (uint32_t) irLength, 1 };
@@ -31,7 +38,9 @@ public:
             singleBandConv.irTransferData.resize ((size_t) irSize, 0.0f);
         }
 
+        latestParams.read (params); // drop any requests from before the crossover was prepared
         params = { lowBandCrossoverHz, highBandCrossoverHz };
+        requestedParams = params;
         updateParams();
 
         for (auto& singleBandConv : convolutions)
@@ -43,26 +52,27 @@ public:
                                                                                          singleBandConv.irTransferData.data()));
             singleBandConv.irTransfer = std::make_unique<IRTransfer> (*singleBandConv.engines[0]);
         }
-        irUpdateState.store (IRUpdateState::Good);
+        irsReady.store (false);
 
-        startTimer (10);
+        workerPool->addJob (*this);
     }
 
     /** Sets the crossover frequency between the low/mid/high bands. */
     void setParameters (float lowBandCrossoverHz, float highBandCrossoverHz)
     {
         // no update needed
-        if (lowBandCrossoverHz == params.lowBandCrossover && highBandCrossoverHz == params.highBandCrossover)
-            return;
-
-        if (irUpdateState != IRUpdateState::Good) // already waiting on an update
+        if (lowBandCrossoverHz == requestedParams.lowBandCrossover && highBandCrossoverHz == requestedParams.highBandCrossover)
             return;
 
         // refresh params
-        params = { lowBandCrossoverHz, highBandCrossoverHz };
-        irUpdateState.store (IRUpdateState::Needed);
+        requestedParams = { lowBandCrossoverHz, highBandCrossoverHz };
+        latestParams.write (requestedParams);
+        requestRun();
     }
 
+    /** Returns the worker pool used to re-compute the IRs, e.g. to monitor its queue depth and latency. */
+    [[nodiscard]] const ConvolutionWorkerPool& getWorkerPool() const noexcept { return *workerPool; }
+
     /** Resets the processor state */
     void reset()
     {
@@ -84,13 +94,13 @@ public:
                                         const BufferView<float>& bufferMid,
                                         const BufferView<float>& bufferHigh) noexcept
     {
-        if (irUpdateState == IRUpdateState::Ready)
+        if (irsReady.load() && attemptIRTransfer())
         {
-            bool irTransferSuccess = true;
-            for (int i = 0; i < 3; ++i)
-                irTransferSuccess &= attemptIRTransfer (i);
-            if (irTransferSuccess)
-                irUpdateState.store (IRUpdateState::Good);
+            irsReady.store (false);
+
+            // the parameters changed again while the last IRs were waiting to be transferred
+            if (latestParams.hasNewValue())
+                requestRun();
         }
 
         const auto numChannels = bufferIn.getNumChannels();
@@ -119,28 +129,36 @@ public:
     }
 
 private:
-    bool attemptIRTransfer (int bandIndex)
+    bool attemptIRTransfer()
     {
-        juce::SpinLock::ScopedTryLockType lock (convolutions[(size_t) bandIndex].irTransfer->mutex);
-        if (! lock.isLocked())
-            return false; // we weren't able to grab the irTransfer lock, so let's skip and  try again later!
+        // the bands need to switch over together, so that they still sum to flat
+        for (auto& singleBandConv : convolutions)
+        {
+            if (! singleBandConv.irTransfer->hasNewIR() || singleBandConv.engines[0]->isCrossfading())
+                return false; // the engines are still crossfading to the previous IRs, so let's skip and try again later!
+        }
 
-        // Lock acquired! Let's do the swap
-        for (const auto& eng : convolutions[(size_t) bandIndex].engines)
-            convolutions[(size_t) bandIndex].irTransfer->transferIR (*eng);
+        for (auto& singleBandConv : convolutions)
+            singleBandConv.irTransfer->transferIR (singleBandConv.engines);
 
         return true;
     }
 
-    void hiResTimerCallback() override
+    void runJob() override
     {
-        if (irUpdateState == IRUpdateState::Needed)
-        {
-            updateParams();
-            for (auto& singleBandConv : convolutions)
-                singleBandConv.irTransfer->setNewIR (singleBandConv.irTransferData.data());
-            irUpdateState.store (IRUpdateState::Ready);
-        }
+        // The bands need to be transferred as a set, so wait until the audio thread has picked
+        // up the last set (it'll ask for another run then, if the parameters have changed).
+        if (irsReady.load())
+            return;
+
+        // if the parameters were changed more than once since the last run, only the latest ones matter
+        if (! latestParams.read (params))
+            return;
+
+        updateParams();
+        for (auto& singleBandConv : convolutions)
+            singleBandConv.irTransfer->setNewIR (singleBandConv.irTransferData.data());
+        irsReady.store (true);
     }
 
     void updateParams()
@@ -209,7 +227,10 @@ private:
     {
         float lowBandCrossover;
         float highBandCrossover;
-    } params;
+    };
+    Params params {}; // the parameters used for the current IRs
+    Params requestedParams {}; // the parameters most recently passed to setParameters()
+    ConvolutionWorkerPool::LatestParameters<Params> latestParams;
 
     struct PrototypeFilters
     {
@@ -251,13 +272,8 @@ private:
         float fs = 48000.0f;
     } prototypeFilters;
 
-    enum class IRUpdateState
-    {
-        Good,
-        Needed,
-        Ready,
-    };
-    std::atomic<IRUpdateState> irUpdateState { IRUpdateState::Good };
+    // set once a new set of IRs has been loaded into the IRTransfers, until they've all been transferred
+    std::atomic<bool> irsReady { false };
 
     struct SingleBandConvolution
     {
@@ -268,9 +284,11 @@ private:
     };
     std::array<SingleBandConvolution, 3> convolutions {};
 
-    std::unique_ptr<juce::dsp::FFT> fft {};
+    std::unique_ptr<DefaultFFT> fft {};
     int irSize = 0;
 
+    juce::SharedResourcePointer<ConvolutionWorkerPool> workerPool;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhase3WayCrossover)
 };
 } // namespace chowdsp
@@ -109,6 +109,22 @@ VariableOversampling<FloatType>::VariableOversampling (const juce::AudioProcesso
     numOSChoices = osParam->choices.size();
 }
 
+template <typename FloatType>
+VariableOversampling<FloatType>::VariableOversampling (const juce::AudioProcessor& processor, const ParameterHandles& params, bool useIntegerLatency)
+    : osParam (params.osFactor),
+      osModeParam (params.osMode),
+      osOfflineParam (params.osRenderFactor),
+      osOfflineModeParam (params.osRenderMode),
+      osOfflineSameParam (params.osRenderLikeRealtime),
+      proc (processor),
+      usingIntegerLatency (useIntegerLatency)
+{
+    jassert (osParam != nullptr && osModeParam != nullptr); // the factor and mode parameters are required!
+    jassert (osOfflineParam == nullptr || (osOfflineModeParam != nullptr && osOfflineSameParam != nullptr)); // all the render parameters are needed to use any of them!
+
+    numOSChoices = osParam->choices.size();
+}
+
 template <typename FloatType>
 void VariableOversampling<FloatType>::createParameterLayout (std::vector<std::unique_ptr<juce::RangedAudioParameter>>& params,
                                                              OSFactor defaultFactor,
@@ -137,25 +153,11 @@ void VariableOversampling<FloatType>::createParameterLayout (std::vector<std::un
                                                              bool includeRenderOptions,
                                                              const juce::String& paramPrefix)
 {
-    juce::StringArray osFactorChoices;
-    int defaultOSFactor = 0;
-    for (auto factor : osFactors)
-    {
-        if (factor == defaultFactor)
-            defaultOSFactor = osFactorChoices.size();
+    const auto osFactorChoices = getOSFactorChoices (osFactors);
+    const auto defaultOSFactor = juce::jmax (0, osFactorChoices.indexOf (osFactorToString (defaultFactor)));
 
-        osFactorChoices.add (osFactorToString (factor));
-    }
-
-    juce::StringArray osModeChoices;
-    int defaultOSMode = 0;
-    for (auto mode : osModes)
-    {
-        if (mode == defaultMode)
-            defaultOSMode = osModeChoices.size();
-
-        osModeChoices.add (osModeToString (mode));
-    }
+    const auto osModeChoices = getOSModeChoices (osModes);
+    const auto defaultOSMode = juce::jmax (0, osModeChoices.indexOf (osModeToString (defaultMode)));
 
     auto getParamID = [&paramPrefix, versionHint] (const juce::String& paramSuffix)
     {
@@ -178,6 +180,26 @@ void VariableOversampling<FloatType>::createParameterLayout (std::vector<std::un
     }
 }
 
+template <typename FloatType>
+juce::StringArray VariableOversampling<FloatType>::getOSFactorChoices (std::initializer_list<OSFactor> osFactors)
+{
+    juce::StringArray osFactorChoices;
+    for (auto factor : osFactors)
+        osFactorChoices.add (osFactorToString (factor));
+
+    return osFactorChoices;
+}
+
+template <typename FloatType>
+juce::StringArray VariableOversampling<FloatType>::getOSModeChoices (std::initializer_list<OSMode> osModes)
+{
+    juce::StringArray osModeChoices;
+    for (auto mode : osModes)
+        osModeChoices.add (osModeToString (mode));
+
+    return osModeChoices;
+}
+
 template <typename FloatType>
 bool VariableOversampling<FloatType>::updateOSFactor()
 {
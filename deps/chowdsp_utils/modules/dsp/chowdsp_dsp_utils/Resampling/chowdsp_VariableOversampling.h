@@ -40,6 +40,29 @@ public:
      */
     explicit VariableOversampling (const juce::AudioProcessorValueTreeState& vts, bool useIntegerLatency = false, const juce::String& paramPrefix = "os");
 
+    /** Handles to the parameters used by the oversamplers. The render parameters are optional. */
+    struct ParameterHandles
+    {
+        juce::AudioParameterChoice* osFactor = nullptr;
+        juce::AudioParameterChoice* osMode = nullptr;
+        juce::AudioParameterChoice* osRenderFactor = nullptr;
+        juce::AudioParameterChoice* osRenderMode = nullptr;
+        juce::AudioParameterBool* osRenderLikeRealtime = nullptr;
+    };
+
+    /**
+     * Construct a variable oversampling object with parameters that are not
+     * held in an APVTS (e.g. parameters held in a chowdsp::PluginState).
+     *
+     * The factor and mode parameters must use the choices from
+     * `getOSFactorChoices()` and `getOSModeChoices()`.
+     *
+     * @param proc              The processor that owns the parameters
+     * @param params            Handles to the oversampling parameters
+     * @param useIntegerLatency Set to true to force the oversamplers to use integer latency
+     */
+    VariableOversampling (const juce::AudioProcessor& proc, const ParameterHandles& params, bool useIntegerLatency = false);
+
     /**
      * Creates a parameter layout for variable oversampling,
      * with all available oversampling options.
@@ -72,6 +95,12 @@ public:
                                        bool includeRenderOptions = true,
                                        const juce::String& paramPrefix = "os");
 
+    /** Returns the parameter choices for a set of oversampling factors */
+    static juce::StringArray getOSFactorChoices (std::initializer_list<OSFactor> osFactors = { OSFactor::OneX, OSFactor::TwoX, OSFactor::FourX, OSFactor::EightX, OSFactor::SixteenX });
+
+    /** Returns the parameter choices for a set of oversampling modes */
+    static juce::StringArray getOSModeChoices (std::initializer_list<OSMode> osModes = { OSMode::MinPhase, OSMode::LinPhase });
+
     /** Prepares the oversamplers to process a new stream of audio */
     void prepareToPlay (double sampleRate, int samplesPerBlock, int numChannels);
 
@@ -12,5 +12,5 @@
 #include "Resampling/chowdsp_VariableOversampling.cpp"
 
 // convolution
-#include "Convolution/chowdsp_IRHelpers.cpp"
+#include "Convolution/chowdsp_ConvolutionWorkerPool.cpp"
 #endif
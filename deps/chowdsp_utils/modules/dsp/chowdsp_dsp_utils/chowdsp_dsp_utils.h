@@ -81,8 +81,19 @@ JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wimplicit-const-int-float-conversion")
 #include <juce_dsp/juce_dsp.h>
 JUCE_END_IGNORE_WARNINGS_GCC_LIKE
 
+#if ! CHOWDSP_USE_SIMD_FFT
+namespace chowdsp
+{
+/** The FFT used by the convolution engines and linear-phase processors by default (see chowdsp_SIMDFFT.h). */
+using DefaultFFT = juce::dsp::FFT;
+} // namespace chowdsp
+#endif
+
 // convolution
 #include "Convolution/chowdsp_ConvolutionEngine.h"
+#include "Convolution/chowdsp_ConvolutionWorkerPool.h"
+#include "Convolution/chowdsp_NonUniformConvolutionEngine.h"
+#include "Convolution/chowdsp_MultiChannelConvolutionEngine.h"
 #include "Convolution/chowdsp_IRTransfer.h"
 #include "Convolution/chowdsp_IRHelpers.h"
 #include "Processors/chowdsp_LinearPhase3WayCrossover.h"
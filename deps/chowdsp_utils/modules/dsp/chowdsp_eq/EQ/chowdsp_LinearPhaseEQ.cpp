@@ -3,7 +3,7 @@ namespace chowdsp::EQ
 template <typename PrototypeEQ, int defaultFIRLength>
 LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::~LinearPhaseEQ()
 {
-    stopTimer();
+    workerPool->removeJob (*this);
 }
 
 template <typename PrototypeEQ, int defaultFIRLength>
@@ -22,56 +22,55 @@ int LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::getIRSize (double sampleRate)
 template <typename PrototypeEQ, int defaultFIRLength>
 void LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::prepare (const juce::dsp::ProcessSpec& spec, const ProtoEQParams& initialParams)
 {
-    stopTimer();
+    workerPool->removeJob (*this);
 
     fs = spec.sampleRate;
     maxBlockSize = (int) spec.maximumBlockSize;
     irSize = getIRSize (fs);
 
     const auto fftOrder = Math::log2 (irSize);
-    fft = std::make_unique<juce::dsp::FFT> (fftOrder);
+    fft = std::make_unique<DefaultFFT> (fftOrder);
 
     prototypeEQ.prepare ({ spec.sampleRate, (juce::uint32) irSize, 1 });
 
     irBuffer.setMaxSize (1, irSize);
     irTransferData.resize ((size_t) irSize, 0.0f);
+    latestParams.read (params.params); // drop any requests from before the EQ was prepared
     params = { initialParams };
+    requestedParams = params;
     updateParams();
 
     engines.clear();
     for (size_t ch = 0; ch < spec.numChannels; ++ch)
         engines.push_back (std::make_unique<ConvolutionEngine<>> ((size_t) irSize, spec.maximumBlockSize, irTransferData.data()));
 
-    irUpdateState.store (IRUpdateState::Good);
     irTransfer = std::make_unique<IRTransfer> (*engines[0]);
 
-    startTimer (10); // @TODO: should we expose the timer frequency to the user?
+    workerPool->addJob (*this);
 }
 
 template <typename PrototypeEQ, int defaultFIRLength>
-void LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::hiResTimerCallback()
+void LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::runJob()
 {
-    if (irUpdateState == IRUpdateState::Needed)
-    {
-        updateParams();
-        irTransfer->setNewIR (irTransferData.data());
-        irUpdateState.store (IRUpdateState::Ready);
-    }
+    // if the parameters were changed more than once since the last run, only the latest ones matter
+    if (! latestParams.read (params.params))
+        return;
+
+    updateParams();
+    irTransfer->setNewIR (irTransferData.data());
 }
 
 template <typename PrototypeEQ, int defaultFIRLength>
 void LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::setParameters (const ProtoEQParams& newParams)
 {
     // no update needed
-    if (params == newParams)
-        return;
-
-    if (irUpdateState != IRUpdateState::Good) // already waiting on an update
+    if (requestedParams == newParams)
         return;
 
     // refresh params
-    params = { newParams };
-    irUpdateState.store (IRUpdateState::Needed);
+    requestedParams = { newParams };
+    latestParams.write (newParams);
+    requestRun();
 }
 
 template <typename PrototypeEQ, int defaultFIRLength>
@@ -102,26 +101,11 @@ void LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::updateParams()
     IRHelpers::makeHalfMagnitude (irTransferData.data(), irTransferData.data(), irSize, *fft);
 }
 
-template <typename PrototypeEQ, int defaultFIRLength>
-bool LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::attemptIRTransfer()
-{
-    juce::SpinLock::ScopedTryLockType lock (irTransfer->mutex);
-    if (! lock.isLocked())
-        return false; // we weren't able to grab the irTransfer lock, so let's skip and  try again later!
-
-    // Lock acquired! Let's do the swap
-    for (const auto& eng : engines)
-        irTransfer->transferIR (*eng);
-
-    irUpdateState.store (IRUpdateState::Good);
-    return true;
-}
-
 template <typename PrototypeEQ, int defaultFIRLength>
 void LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::processBlock (const BufferView<float>& buffer) noexcept
 {
-    if (irUpdateState == IRUpdateState::Ready)
-        attemptIRTransfer();
+    // if there's a new IR, and the engines aren't still crossfading to the previous one, start crossfading to it
+    irTransfer->transferIR (engines);
 
     const auto numChannels = buffer.getNumChannels();
     const auto numSamples = buffer.getNumSamples();
@@ -152,8 +136,7 @@ template <typename PrototypeEQ, int defaultFIRLength>
 template <typename ProcessContext>
 void LinearPhaseEQ<PrototypeEQ, defaultFIRLength>::process (const ProcessContext& context) noexcept
 {
-    if (irUpdateState == IRUpdateState::Ready)
-        attemptIRTransfer();
+    irTransfer->transferIR (engines);
 
     auto&& inBlock = context.getInputBlock();
     auto&& outBlock = context.getOutputBlock();
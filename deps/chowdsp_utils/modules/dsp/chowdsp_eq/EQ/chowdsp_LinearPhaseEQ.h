@@ -47,9 +47,13 @@ struct LinearPhasePrototypeEQ
  *   - `PrototypeEQ::processBlock (juce::AudioBuffer<float>&)` (note that the buffer passed in will only contain one channel)
  *
  * The defaultFIRLength represents the FIR filter length to use at 48 kHz sampling rate.
+ *
+ * When the parameters change, the IR is re-computed on the ConvolutionWorkerPool that's
+ * shared between all the convolution processors in the process. If the parameters
+ * change again before that happens, only the latest parameters are used.
  */
 template <typename PrototypeEQ, int defaultFIRLength = 4096>
-class LinearPhaseEQ : private juce::HighResolutionTimer
+class LinearPhaseEQ : private ConvolutionWorkerPool::Job
 {
     using ProtoEQParams = typename PrototypeEQ::Params;
 
@@ -77,17 +81,21 @@ public:
     /** Returns the latency introduced by this processor. */
     [[nodiscard]] int getLatencySamples() const noexcept;
 
+    /** Returns the worker pool used to re-compute the IR, e.g. to monitor its queue depth and latency. */
+    [[nodiscard]] const ConvolutionWorkerPool& getWorkerPool() const noexcept { return *workerPool; }
+
 private:
     static int getIRSize (double sampleRate);
 
     void updateParams();
-    void hiResTimerCallback() override;
+    void runJob() override;
 
-    bool attemptIRTransfer();
     void processBlocksInternal (const AudioBlock<const float>& inputBlock, AudioBlock<float>& outputBlock) noexcept;
 
     PrototypeEQ prototypeEQ;
-    EQParams<ProtoEQParams> params {};
+    EQParams<ProtoEQParams> params {}; // the parameters used for the current IR
+    EQParams<ProtoEQParams> requestedParams {}; // the parameters most recently passed to setParameters()
+    ConvolutionWorkerPool::LatestParameters<ProtoEQParams> latestParams;
 
     std::vector<std::unique_ptr<ConvolutionEngine<>>> engines;
     std::unique_ptr<IRTransfer> irTransfer;
@@ -98,15 +106,9 @@ private:
     int maxBlockSize = 512;
     int irSize = 0;
 
-    enum class IRUpdateState
-    {
-        Good,
-        Needed,
-        Ready,
-    };
-    std::atomic<IRUpdateState> irUpdateState;
+    std::unique_ptr<DefaultFFT> fft;
 
-    std::unique_ptr<juce::dsp::FFT> fft;
+    juce::SharedResourcePointer<ConvolutionWorkerPool> workerPool;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinearPhaseEQ)
 };
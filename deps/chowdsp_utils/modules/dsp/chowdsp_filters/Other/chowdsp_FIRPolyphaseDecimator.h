@@ -20,7 +20,7 @@ public:
         const auto numCoeffs = coeffs.size();
         const auto coeffsPerFilter = Math::ceiling_divide (numCoeffs, (size_t) decimationFactor);
 
-        std::vector<float> oneFilterCoeffs (coeffsPerFilter);
+        std::vector<T> oneFilterCoeffs (coeffsPerFilter);
 
 #if JUCE_TEENSY
         bufferPtrs.resize ((size_t) decimationFactor);
@@ -48,6 +48,14 @@ public:
         }
     }
 
+    /** Resets the filter state. */
+    void reset() noexcept
+    {
+        for (auto& filter : filters)
+            filter.reset();
+        std::fill (overlapState.begin(), overlapState.end(), T {});
+    }
+
     /**
      * Processes a block of data.
      *
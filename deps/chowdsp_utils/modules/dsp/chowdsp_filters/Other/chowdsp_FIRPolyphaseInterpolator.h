@@ -19,7 +19,7 @@ public:
         const auto numCoeffs = coeffs.size();
         const auto coeffsPerFilter = Math::ceiling_divide (numCoeffs, (size_t) interpolationFactor);
 
-        std::vector<float> oneFilterCoeffs (coeffsPerFilter);
+        std::vector<T> oneFilterCoeffs (coeffsPerFilter);
 
 #if JUCE_TEENSY
         bufferPtrs.resize ((size_t) interpolationFactor);
@@ -46,6 +46,13 @@ public:
         }
     }
 
+    /** Resets the filter state. */
+    void reset() noexcept
+    {
+        for (auto& filter : filters)
+            filter.reset();
+    }
+
     /**
      * Processes a block of data.
      *
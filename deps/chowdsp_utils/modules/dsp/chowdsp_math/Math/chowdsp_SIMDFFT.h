@@ -0,0 +1,455 @@
+#pragma once
+
+#include <complex>
+
+namespace chowdsp
+{
+#if ! CHOWDSP_NO_XSIMD
+#ifndef DOXYGEN
+namespace SIMDFFTDetail
+{
+    template <typename T>
+    inline T loadSamples (const float* ptr) noexcept
+    {
+        if constexpr (std::is_same_v<T, float>)
+            return *ptr;
+        else
+            return xsimd::load_unaligned (ptr);
+    }
+
+    template <typename T>
+    inline void storeSamples (float* ptr, T x) noexcept
+    {
+        if constexpr (std::is_same_v<T, float>)
+            *ptr = x;
+        else
+            x.store_unaligned (ptr);
+    }
+
+    /**
+     * An unscaled complex FFT on split (real/imaginary) data.
+     *
+     * The transform is made of radix-4 Stockham passes (plus one radix-2
+     * pass for odd orders), so there's no bit-reversal, and every pass after
+     * the first couple runs over contiguous runs of at least one SIMD
+     * register's worth of data, with the twiddle factors broadcast.
+     */
+    class SplitComplexFFT
+    {
+    public:
+        explicit SplitComplexFFT (int order)
+            : size ((size_t) 1 << order),
+              scratchRe (size),
+              scratchIm (size)
+        {
+            size_t n = size, stride = 1;
+            for (; n >= 4; n /= 4, stride *= 4)
+            {
+                Radix4Pass pass { n, stride, std::vector<float> (6 * (n / 4)) };
+                const auto n1 = n / 4;
+                for (size_t p = 0; p < n1; ++p)
+                {
+                    for (size_t k = 1; k <= 3; ++k)
+                    {
+                        const auto angle = -juce::MathConstants<double>::twoPi * double (k * p) / double (n);
+                        pass.twiddles[(2 * k - 2) * n1 + p] = (float) std::cos (angle);
+                        pass.twiddles[(2 * k - 1) * n1 + p] = (float) std::sin (angle);
+                    }
+                }
+                radix4Passes.push_back (std::move (pass));
+            }
+
+            radix2Stride = n == 2 ? stride : 0;
+        }
+
+        /** Transforms the data in-place. The inverse transform is not scaled. */
+        template <bool inverse>
+        void perform (float* re, float* im) noexcept
+        {
+            auto* xr = re;
+            auto* xi = im;
+            auto* yr = scratchRe.data();
+            auto* yi = scratchIm.data();
+
+            for (const auto& pass : radix4Passes)
+            {
+                runRadix4Pass<inverse> (pass, xr, xi, yr, yi);
+                std::swap (xr, yr);
+                std::swap (xi, yi);
+            }
+
+            if (radix2Stride > 0)
+            {
+                runRadix2Pass (xr, xi, yr, yi);
+                std::swap (xr, yr);
+                std::swap (xi, yi);
+            }
+
+            if (xr != re)
+            {
+                std::copy (xr, xr + size, re);
+                std::copy (xi, xi + size, im);
+            }
+        }
+
+        const size_t size;
+
+    private:
+        struct Radix4Pass
+        {
+            size_t n;
+            size_t stride;
+            std::vector<float> twiddles; // w^p, w^2p, w^3p, as all the real parts then all the imaginary parts
+        };
+
+        /** One radix-4 butterfly, where T is float or an XSIMD batch, and W (the twiddle type) is float or T. */
+        template <bool inverse, typename T, typename W>
+        static void radix4Butterfly (const T (&xr)[4], const T (&xi)[4], const W (&wr)[3], const W (&wi)[3], T (&yr)[4], T (&yi)[4]) noexcept
+        {
+            const auto apcR = xr[0] + xr[2], apcI = xi[0] + xi[2];
+            const auto amcR = xr[0] - xr[2], amcI = xi[0] - xi[2];
+            const auto bpdR = xr[1] + xr[3], bpdI = xi[1] + xi[3];
+            const auto bmdR = xr[1] - xr[3], bmdI = xi[1] - xi[3];
+
+            // (a - c) -/+ j(b - d), with the signs swapped for the inverse transform
+            const T t1R = inverse ? amcR - bmdI : amcR + bmdI;
+            const T t1I = inverse ? amcI + bmdR : amcI - bmdR;
+            const T t3R = inverse ? amcR + bmdI : amcR - bmdI;
+            const T t3I = inverse ? amcI - bmdR : amcI + bmdR;
+            const T t2R = apcR - bpdR, t2I = apcI - bpdI;
+
+            // the inverse transform uses the conjugate twiddles
+            yr[0] = apcR + bpdR;
+            yi[0] = apcI + bpdI;
+            if constexpr (inverse)
+            {
+                yr[1] = t1R * wr[0] + t1I * wi[0];
+                yi[1] = t1I * wr[0] - t1R * wi[0];
+                yr[2] = t2R * wr[1] + t2I * wi[1];
+                yi[2] = t2I * wr[1] - t2R * wi[1];
+                yr[3] = t3R * wr[2] + t3I * wi[2];
+                yi[3] = t3I * wr[2] - t3R * wi[2];
+            }
+            else
+            {
+                yr[1] = t1R * wr[0] - t1I * wi[0];
+                yi[1] = t1R * wi[0] + t1I * wr[0];
+                yr[2] = t2R * wr[1] - t2I * wi[1];
+                yi[2] = t2R * wi[1] + t2I * wr[1];
+                yr[3] = t3R * wr[2] - t3I * wi[2];
+                yi[3] = t3R * wi[2] + t3I * wr[2];
+            }
+        }
+
+        /** Runs the butterflies for one twiddle index `p`, vectorised over the contiguous samples `q`. */
+        template <bool inverse, typename T>
+        static void radix4ButterfliesOverQ (const Radix4Pass& pass, size_t p, size_t qStart, size_t qEnd, const float* xr, const float* xi, float* yr, float* yi) noexcept
+        {
+            const auto n1 = pass.n / 4;
+            const auto s = pass.stride;
+            const auto* tw = pass.twiddles.data();
+            const float wr[3] { tw[p], tw[2 * n1 + p], tw[4 * n1 + p] };
+            const float wi[3] { tw[n1 + p], tw[3 * n1 + p], tw[5 * n1 + p] };
+
+            constexpr size_t step = std::is_same_v<T, float> ? 1 : xsimd::batch<float>::size;
+            for (auto q = qStart; q < qEnd; q += step)
+            {
+                T inR[4], inI[4], outR[4], outI[4];
+                for (size_t m = 0; m < 4; ++m)
+                {
+                    inR[m] = loadSamples<T> (xr + q + s * (p + m * n1));
+                    inI[m] = loadSamples<T> (xi + q + s * (p + m * n1));
+                }
+
+                radix4Butterfly<inverse> (inR, inI, wr, wi, outR, outI);
+
+                for (size_t m = 0; m < 4; ++m)
+                {
+                    storeSamples (yr + q + s * (4 * p + m), outR[m]);
+                    storeSamples (yi + q + s * (4 * p + m), outI[m]);
+                }
+            }
+        }
+
+        /**
+         * Runs the butterflies for one offset `q`, vectorised over the twiddle indices `p`.
+         * This is used for the first passes, where the runs of contiguous samples are
+         * shorter than a SIMD register, so the samples are gathered and scattered instead.
+         */
+        template <bool inverse>
+        static void radix4ButterfliesOverP (const Radix4Pass& pass, size_t q, size_t pEnd, const float* xr, const float* xi, float* yr, float* yi) noexcept
+        {
+            using Vec = xsimd::batch<float>;
+            using IndexVec = xsimd::batch<int32_t, Vec::arch_type>;
+            static_assert (IndexVec::size == Vec::size);
+
+            const auto n1 = pass.n / 4;
+            const auto s = pass.stride;
+            const auto* tw = pass.twiddles.data();
+
+            alignas (Vec::arch_type::alignment()) int32_t lanes[Vec::size] {};
+            for (size_t i = 0; i < Vec::size; ++i)
+                lanes[i] = (int32_t) i;
+            const auto laneIndex = IndexVec::load_aligned (lanes);
+            const auto inIndex = laneIndex * (int32_t) s;
+            const auto outIndex = laneIndex * (int32_t) (4 * s);
+
+            for (size_t p = 0; p < pEnd; p += Vec::size)
+            {
+                Vec inR[4], inI[4], outR[4], outI[4];
+                for (size_t m = 0; m < 4; ++m)
+                {
+                    inR[m] = Vec::gather (xr + q + s * (p + m * n1), inIndex);
+                    inI[m] = Vec::gather (xi + q + s * (p + m * n1), inIndex);
+                }
+
+                const Vec wr[3] { Vec::load_unaligned (tw + p), Vec::load_unaligned (tw + 2 * n1 + p), Vec::load_unaligned (tw + 4 * n1 + p) };
+                const Vec wi[3] { Vec::load_unaligned (tw + n1 + p), Vec::load_unaligned (tw + 3 * n1 + p), Vec::load_unaligned (tw + 5 * n1 + p) };
+                radix4Butterfly<inverse> (inR, inI, wr, wi, outR, outI);
+
+                for (size_t m = 0; m < 4; ++m)
+                {
+                    outR[m].scatter (yr + q + s * (4 * p + m), outIndex);
+                    outI[m].scatter (yi + q + s * (4 * p + m), outIndex);
+                }
+            }
+        }
+
+        template <bool inverse>
+        static void runRadix4Pass (const Radix4Pass& pass, const float* xr, const float* xi, float* yr, float* yi) noexcept
+        {
+            constexpr auto vecSize = xsimd::batch<float>::size;
+            const auto n1 = pass.n / 4;
+
+            if (pass.stride < vecSize && n1 >= vecSize)
+            {
+                const auto numVecTwiddles = n1 - n1 % vecSize;
+                for (size_t q = 0; q < pass.stride; ++q)
+                    radix4ButterfliesOverP<inverse> (pass, q, numVecTwiddles, xr, xi, yr, yi);
+
+                for (size_t p = numVecTwiddles; p < n1; ++p)
+                    radix4ButterfliesOverQ<inverse, float> (pass, p, 0, pass.stride, xr, xi, yr, yi);
+
+                return;
+            }
+
+            const auto numVecSamples = pass.stride - pass.stride % vecSize;
+            for (size_t p = 0; p < n1; ++p)
+            {
+                radix4ButterfliesOverQ<inverse, xsimd::batch<float>> (pass, p, 0, numVecSamples, xr, xi, yr, yi);
+                radix4ButterfliesOverQ<inverse, float> (pass, p, numVecSamples, pass.stride, xr, xi, yr, yi);
+            }
+        }
+
+        void runRadix2Pass (const float* xr, const float* xi, float* yr, float* yi) const noexcept
+        {
+            const auto s = radix2Stride;
+            for (size_t q = 0; q < s; ++q)
+            {
+                yr[q] = xr[q] + xr[q + s];
+                yi[q] = xi[q] + xi[q + s];
+                yr[q + s] = xr[q] - xr[q + s];
+                yi[q + s] = xi[q] - xi[q + s];
+            }
+        }
+
+        std::vector<Radix4Pass> radix4Passes;
+        size_t radix2Stride = 0;
+        std::vector<float> scratchRe, scratchIm;
+    };
+} // namespace SIMDFFTDetail
+#endif
+
+/**
+ * A header-only FFT, vectorised with XSIMD, with the same interface as juce::dsp::FFT,
+ * so it can be used as the FFTEngineType for ConvolutionEngine and friends.
+ *
+ * Real-only transforms are computed with a half-size complex FFT, and the complex
+ * FFTs are done on split real/imaginary data, in radix-4 passes that are
+ * vectorised over contiguous runs of butterflies.
+ *
+ * Unlike juce::dsp::FFT, this class keeps some scratch memory for the transforms,
+ * so one FFT object should not be used by more than one thread at a time.
+ */
+class SIMDFFT
+{
+public:
+    /** Creates an FFT of size 2^order. */
+    explicit SIMDFFT (int order)
+        : fftOrder (order),
+          fftSize (1 << order),
+          complexFFT (order),
+          halfSizeFFT (juce::jmax (0, order - 1)),
+          scratchRe ((size_t) fftSize),
+          scratchIm ((size_t) fftSize)
+    {
+        const auto halfSize = (size_t) fftSize / 2;
+        realTwiddlesRe.resize (halfSize + 1);
+        realTwiddlesIm.resize (halfSize + 1);
+        for (size_t k = 0; k <= halfSize; ++k)
+        {
+            const auto angle = -juce::MathConstants<double>::twoPi * double (k) / double (fftSize);
+            realTwiddlesRe[k] = (float) std::cos (angle);
+            realTwiddlesIm[k] = (float) std::sin (angle);
+        }
+    }
+
+    /** Returns the FFT order. */
+    [[nodiscard]] int getOrder() const noexcept { return fftOrder; }
+
+    /** Returns the FFT size. */
+    [[nodiscard]] int getSize() const noexcept { return fftSize; }
+
+    /** Performs a complex FFT. The inverse transform is scaled by 1 / size. */
+    void perform (const std::complex<float>* input, std::complex<float>* output, bool inverse) const noexcept
+    {
+        for (size_t k = 0; k < (size_t) fftSize; ++k)
+        {
+            scratchRe[k] = input[k].real();
+            scratchIm[k] = input[k].imag();
+        }
+
+        if (inverse)
+            complexFFT.perform<true> (scratchRe.data(), scratchIm.data());
+        else
+            complexFFT.perform<false> (scratchRe.data(), scratchIm.data());
+
+        const auto scale = inverse ? 1.0f / (float) fftSize : 1.0f;
+        for (size_t k = 0; k < (size_t) fftSize; ++k)
+            output[k] = { scratchRe[k] * scale, scratchIm[k] * scale };
+    }
+
+    /**
+     * Performs an in-place FFT on real data, in the same format as juce::dsp::FFT:
+     * `inputOutputData` holds `size` real samples, and is replaced by `size` complex
+     * bins (or just the first `size / 2 + 1` bins), so it must have space for `2 * size` floats.
+     */
+    void performRealOnlyForwardTransform (float* inputOutputData, bool onlyCalculateNonNegativeFrequencies = false) const noexcept
+    {
+        if (fftSize == 1)
+        {
+            inputOutputData[1] = 0.0f;
+            return;
+        }
+
+        // The even and odd samples go in the real and imaginary parts of a half-size complex FFT,
+        // and then, with E and O their spectra: X[k] = E[k] + W^k O[k], with W = e^(-2 pi j / N).
+        const auto halfSize = (size_t) fftSize / 2;
+        for (size_t k = 0; k < halfSize; ++k)
+        {
+            scratchRe[k] = inputOutputData[2 * k];
+            scratchIm[k] = inputOutputData[2 * k + 1];
+        }
+
+        halfSizeFFT.perform<false> (scratchRe.data(), scratchIm.data());
+
+        for (size_t k = 0; k <= halfSize; ++k)
+        {
+            const auto kIndex = k % halfSize;
+            const auto mirrorIndex = (halfSize - k) % halfSize;
+            const auto zRe = scratchRe[kIndex], zIm = scratchIm[kIndex];
+            const auto zMirrorRe = scratchRe[mirrorIndex], zMirrorIm = -scratchIm[mirrorIndex];
+
+            const auto evenRe = 0.5f * (zRe + zMirrorRe), evenIm = 0.5f * (zIm + zMirrorIm);
+            const auto oddRe = 0.5f * (zIm - zMirrorIm), oddIm = -0.5f * (zRe - zMirrorRe);
+
+            const auto wRe = realTwiddlesRe[k], wIm = realTwiddlesIm[k];
+            inputOutputData[2 * k] = evenRe + wRe * oddRe - wIm * oddIm;
+            inputOutputData[2 * k + 1] = evenIm + wRe * oddIm + wIm * oddRe;
+        }
+
+        if (onlyCalculateNonNegativeFrequencies)
+            return;
+
+        for (size_t k = halfSize + 1; k < (size_t) fftSize; ++k)
+        {
+            inputOutputData[2 * k] = inputOutputData[2 * ((size_t) fftSize - k)];
+            inputOutputData[2 * k + 1] = -inputOutputData[2 * ((size_t) fftSize - k) + 1];
+        }
+    }
+
+    /**
+     * Performs a reverse FFT in-place, in the same format as juce::dsp::FFT:
+     * `inputOutputData` holds `size` complex bins, and is replaced by the real part
+     * of the inverse transform (scaled by 1 / size).
+     */
+    void performRealOnlyInverseTransform (float* inputOutputData) const noexcept
+    {
+        if (fftSize == 1)
+            return;
+
+        // The real part of the inverse transform only depends on the conjugate-symmetric part of the spectrum
+        const auto getSymmetricBin = [inputOutputData, n = (size_t) fftSize] (size_t k)
+        {
+            const auto mirror = (n - k) % n;
+            return std::complex<float> { 0.5f * (inputOutputData[2 * k] + inputOutputData[2 * mirror]),
+                                         0.5f * (inputOutputData[2 * k + 1] - inputOutputData[2 * mirror + 1]) };
+        };
+
+        // The reverse of performRealOnlyForwardTransform(): E[k] = (X[k] + X*[N/2 - k]) / 2,
+        // O[k] = (X[k] - X*[N/2 - k]) W^-k / 2, and the half-size inverse FFT of E + jO
+        // gives the even samples in the real part, and the odd samples in the imaginary part.
+        const auto halfSize = (size_t) fftSize / 2;
+        for (size_t k = 0; k < halfSize; ++k)
+        {
+            const auto x = getSymmetricBin (k);
+            const auto xMirror = std::conj (getSymmetricBin (halfSize - k));
+
+            const auto even = 0.5f * (x + xMirror);
+            const auto odd = 0.5f * (x - xMirror) * std::complex<float> { realTwiddlesRe[k], -realTwiddlesIm[k] };
+
+            scratchRe[k] = even.real() - odd.imag();
+            scratchIm[k] = even.imag() + odd.real();
+        }
+
+        halfSizeFFT.perform<true> (scratchRe.data(), scratchIm.data());
+
+        const auto scale = 1.0f / (float) halfSize;
+        for (size_t k = 0; k < halfSize; ++k)
+        {
+            inputOutputData[2 * k] = scratchRe[k] * scale;
+            inputOutputData[2 * k + 1] = scratchIm[k] * scale;
+        }
+    }
+
+    /**
+     * Computes the magnitude spectrum of some real data, in-place, in the same format as
+     * juce::dsp::FFT: `inputOutputData` must have space for `2 * size` floats.
+     */
+    void performFrequencyOnlyForwardTransform (float* inputOutputData, bool ignoreNegativeFreqs = false) const noexcept
+    {
+        performRealOnlyForwardTransform (inputOutputData, ignoreNegativeFreqs);
+
+        const auto numBins = ignoreNegativeFreqs ? fftSize / 2 + 1 : fftSize;
+        for (int k = 0; k < numBins; ++k)
+            inputOutputData[k] = std::hypot (inputOutputData[2 * k], inputOutputData[2 * k + 1]);
+
+        std::fill (inputOutputData + numBins, inputOutputData + 2 * fftSize, 0.0f);
+    }
+
+private:
+    const int fftOrder;
+    const int fftSize;
+
+    mutable SIMDFFTDetail::SplitComplexFFT complexFFT, halfSizeFFT;
+    mutable std::vector<float> scratchRe, scratchIm;
+    std::vector<float> realTwiddlesRe, realTwiddlesIm;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SIMDFFT)
+};
+#endif // ! CHOWDSP_NO_XSIMD
+
+#if CHOWDSP_USE_SIMD_FFT
+/**
+ * The FFT used by the convolution engines, linear-phase processors, and filter plotters
+ * by default. When CHOWDSP_USE_SIMD_FFT is disabled (e.g. to use Accelerate, MKL, or FFTW
+ * via JUCE instead), chowdsp_dsp_utils and chowdsp_visualizers declare it as juce::dsp::FFT,
+ * since this module doesn't depend on juce_dsp.
+ *
+ * Note that SIMDFFT's transforms are const, but write to the object's (mutable) scratch
+ * memory, so unlike juce::dsp::FFT, a DefaultFFT must not be shared between threads: give
+ * each thread that does transforms its own FFT object.
+ */
+using DefaultFFT = SIMDFFT;
+#endif
+} // namespace chowdsp
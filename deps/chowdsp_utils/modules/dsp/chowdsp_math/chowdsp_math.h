@@ -25,6 +25,21 @@ BEGIN_JUCE_MODULE_DECLARATION
 #include <chowdsp_data_structures/chowdsp_data_structures.h>
 #include <chowdsp_simd/chowdsp_simd.h>
 
+/** Config: CHOWDSP_USE_SIMD_FFT
+           Use chowdsp::SIMDFFT (rather than juce::dsp::FFT) as the default FFT for
+           the convolution engines, linear-phase processors, and filter plotters.
+
+           By default this is enabled unless JUCE is already using a platform or
+           third-party FFT library (Accelerate on Apple platforms, Intel MKL, or FFTW).
+ */
+#ifndef CHOWDSP_USE_SIMD_FFT
+#if CHOWDSP_NO_XSIMD || JUCE_MAC || JUCE_IOS || JUCE_DSP_USE_INTEL_MKL || JUCE_DSP_USE_SHARED_FFTW || JUCE_DSP_USE_STATIC_FFTW
+#define CHOWDSP_USE_SIMD_FFT 0
+#else
+#define CHOWDSP_USE_SIMD_FFT 1
+#endif
+#endif
+
 JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wimplicit-int-float-conversion", "-Wfloat-equal")
 #include "third_party/gcem/include/gcem.hpp"
 JUCE_END_IGNORE_WARNINGS_GCC_LIKE
@@ -51,3 +66,5 @@ JUCE_END_IGNORE_WARNINGS_GCC_LIKE
 #include <chowdsp_buffers/chowdsp_buffers.h>
 #include "Math/chowdsp_BufferMath.h"
 #endif
+
+#include "Math/chowdsp_SIMDFFT.h"
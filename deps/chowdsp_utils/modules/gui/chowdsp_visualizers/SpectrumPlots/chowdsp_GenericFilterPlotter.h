@@ -47,7 +47,7 @@ private:
     static void freqSmooth (const std::vector<float>& magsDB, std::vector<float>& magsSmoothDB, float smFactor = 1.0f / 24.0f);
 
     const SpectrumPlotBase& base;
-    juce::dsp::FFT fft;
+    DefaultFFT fft;
     const int fftSize;
 
     juce::Path plotPath;
@@ -8,7 +8,7 @@ BEGIN_JUCE_MODULE_DECLARATION
    version:       2.3.0
    name:          ChowDSP Visualizer Utilities
    description:   UI visualizer components for ChowDSP plugins
-   dependencies:  juce_gui_basics, juce_audio_basics, chowdsp_filters
+   dependencies:  juce_gui_basics, juce_audio_basics, juce_dsp, chowdsp_filters
 
    website:       https://ccrma.stanford.edu/~jatin/chowdsp
    license:       GPLv3
@@ -26,6 +26,18 @@ BEGIN_JUCE_MODULE_DECLARATION
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <chowdsp_filters/chowdsp_filters.h>
 
+#if ! CHOWDSP_USE_SIMD_FFT
+JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wimplicit-const-int-float-conversion")
+#include <juce_dsp/juce_dsp.h>
+JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+
+namespace chowdsp
+{
+/** The FFT used by the filter plotters by default (see chowdsp_SIMDFFT.h). */
+using DefaultFFT = juce::dsp::FFT;
+} // namespace chowdsp
+#endif
+
 #if JUCE_MODULE_AVAILABLE_chowdsp_eq
 #include <chowdsp_eq/chowdsp_eq.h>
 #endif
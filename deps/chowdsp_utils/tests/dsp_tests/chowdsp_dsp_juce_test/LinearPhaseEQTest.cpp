@@ -81,9 +81,56 @@ TEST_CASE ("Linear Phase EQ Test", "[dsp][EQ]")
         testEQ.setParameters ({ false });
         testEQ.setParameters ({ false });
         juce::MessageManager::getInstance()->runDispatchLoopUntil (100);
+
+        // give the EQ a few blocks to crossfade to the new IR
+        for (int i = 0; i < 8; ++i)
+            processBlock();
         REQUIRE_MESSAGE (processBlock() < 0.1f, "Processing OFF is incorrect!");
     }
 
+    SECTION ("Shared Worker Pool Test")
+    {
+        static constexpr int FIRLength = 128;
+        std::array<chowdsp::EQ::LinearPhaseEQ<NotAFilter, FIRLength>, 8> testEQs;
+        for (auto& eq : testEQs)
+        {
+            eq.updatePrototypeEQParameters = [] (auto& proto, auto& params)
+            { proto.onOff = params.onOff; };
+            eq.prepare ({ Constants::sampleRate, Constants::blockSize, 1 }, { true });
+        }
+
+        // all the EQs should be sharing one pool
+        const auto& pool = testEQs[0].getWorkerPool();
+        for (auto& eq : testEQs)
+            REQUIRE (&eq.getWorkerPool() == &pool);
+        REQUIRE (pool.getNumThreads() <= 4);
+
+        // lots of redundant requests, of which only the last should matter...
+        for (int i = 0; i < 100; ++i)
+            for (auto& eq : testEQs)
+                eq.setParameters ({ i % 2 == 0 });
+        REQUIRE (pool.getQueueDepth() <= (int) testEQs.size());
+
+        for (int i = 0; i < 5000 && pool.isBusy(); ++i)
+            juce::Thread::sleep (1);
+        REQUIRE (! pool.isBusy());
+        REQUIRE (pool.getQueueDepth() == 0);
+        REQUIRE (pool.getMaxLatencyMs() > 0.0);
+
+        for (auto& eq : testEQs)
+        {
+            juce::AudioBuffer<float> buffer (1, Constants::blockSize);
+            for (int i = 0; i < 10; ++i)
+            {
+                buffer.clear();
+                buffer.setSample (0, 0, 1.0f);
+                auto&& block = juce::dsp::AudioBlock<float> { buffer };
+                eq.process (juce::dsp::ProcessContextReplacing<float> { block });
+            }
+            REQUIRE_MESSAGE (buffer.getMagnitude (0, Constants::blockSize) < 0.1f, "The latest parameters were not used!");
+        }
+    }
+
     SECTION ("FIR Length Test")
     {
         static constexpr int FIRLength = 16;
@@ -0,0 +1,103 @@
+#include <CatchUtils.h>
+#include <juce_dsp/juce_dsp.h>
+#include <chowdsp_math/chowdsp_math.h>
+
+namespace
+{
+// the FFT errors grow with the transform size, so they're compared relative to the size
+float getTolerance (int order) { return 1.0e-6f * (float) (1 << order); }
+
+std::vector<float> makeRandomSignal (size_t size, juce::Random& rand)
+{
+    std::vector<float> signal (size);
+    for (auto& x : signal)
+        x = rand.nextFloat() * 2.0f - 1.0f;
+    return signal;
+}
+} // namespace
+
+TEST_CASE ("SIMD FFT Test", "[dsp][fft]")
+{
+    juce::Random rand { 0x5678 };
+
+    SECTION ("Complex Transform Test")
+    {
+        for (int order = 0; order <= 14; ++order)
+        {
+            const auto size = (size_t) 1 << order;
+            juce::dsp::FFT refFFT { order };
+            chowdsp::SIMDFFT testFFT { order };
+            REQUIRE (testFFT.getSize() == refFFT.getSize());
+
+            std::vector<std::complex<float>> input (size);
+            for (auto& x : input)
+                x = { rand.nextFloat() * 2.0f - 1.0f, rand.nextFloat() * 2.0f - 1.0f };
+
+            std::vector<std::complex<float>> refOutput (size), testOutput (size);
+            for (bool inverse : { false, true })
+            {
+                refFFT.perform (input.data(), refOutput.data(), inverse);
+                testFFT.perform (input.data(), testOutput.data(), inverse);
+
+                for (size_t k = 0; k < size; ++k)
+                    REQUIRE_MESSAGE (std::abs (testOutput[k] - refOutput[k]) < getTolerance (order), "Complex FFT is incorrect for order " << order);
+            }
+        }
+    }
+
+    SECTION ("Real Transform Test")
+    {
+        for (int order = 0; order <= 16; ++order)
+        {
+            const auto size = (size_t) 1 << order;
+            juce::dsp::FFT refFFT { order };
+            chowdsp::SIMDFFT testFFT { order };
+
+            const auto signal = makeRandomSignal (size, rand);
+            for (bool onlyNonNegative : { false, true })
+            {
+                std::vector<float> refData (2 * size), testData (2 * size);
+                std::copy (signal.begin(), signal.end(), refData.begin());
+                std::copy (signal.begin(), signal.end(), testData.begin());
+
+                refFFT.performRealOnlyForwardTransform (refData.data(), onlyNonNegative);
+                testFFT.performRealOnlyForwardTransform (testData.data(), onlyNonNegative);
+
+                const auto numBins = onlyNonNegative ? size / 2 + 1 : size;
+                for (size_t i = 0; i < 2 * numBins; ++i)
+                    REQUIRE_MESSAGE (testData[i] == Catch::Approx { refData[i] }.margin (getTolerance (order)), "Real FFT is incorrect for order " << order);
+
+                if (onlyNonNegative)
+                    continue;
+
+                // and back again...
+                testFFT.performRealOnlyInverseTransform (testData.data());
+                for (size_t n = 0; n < size; ++n)
+                    REQUIRE_MESSAGE (testData[n] == Catch::Approx { signal[n] }.margin (1.0e-5f), "Real inverse FFT is incorrect for order " << order);
+            }
+        }
+    }
+
+    SECTION ("Frequency-Only Transform Test")
+    {
+        constexpr int order = 10;
+        constexpr size_t size = 1 << order;
+        juce::dsp::FFT refFFT { order };
+        chowdsp::SIMDFFT testFFT { order };
+
+        const auto signal = makeRandomSignal (size, rand);
+        for (bool ignoreNegative : { false, true })
+        {
+            std::vector<float> refData (2 * size), testData (2 * size);
+            std::copy (signal.begin(), signal.end(), refData.begin());
+            std::copy (signal.begin(), signal.end(), testData.begin());
+
+            refFFT.performFrequencyOnlyForwardTransform (refData.data(), ignoreNegative);
+            testFFT.performFrequencyOnlyForwardTransform (testData.data(), ignoreNegative);
+
+            const auto numBins = ignoreNegative ? size / 2 + 1 : size;
+            for (size_t k = 0; k < numBins; ++k)
+                REQUIRE (testData[k] == Catch::Approx { refData[k] }.margin (getTolerance (order)));
+        }
+    }
+}
@@ -1,5 +1,4 @@
-#include <CatchUtils.h>
-#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
+#include "ConvolutionTestUtils.h"
 
 static void createTestIR (std::vector<float>& ir, size_t size)
 {
@@ -95,6 +94,135 @@ TEST_CASE ("Convolution Test", "[dsp][convolution]")
         REQUIRE_MESSAGE (maxDiff < 0.5f, "IR Transfer is not smooth enough!");
     }
 
+    SECTION ("Crossfaded Transfer Test")
+    {
+        constexpr size_t irSize = 2000;
+        constexpr size_t blockSize = 64;
+        constexpr size_t numCrossfadeBlocks = 3;
+
+        std::vector<float> testIR (irSize), testIR2 (irSize);
+        juce::Random rand { 0x1234 };
+        for (size_t i = 0; i < irSize; ++i)
+        {
+            testIR[i] = rand.nextFloat() * 2.0f - 1.0f;
+            testIR2[i] = rand.nextFloat() * 2.0f - 1.0f;
+        }
+
+        chowdsp::ConvolutionEngine engine (irSize, blockSize, testIR.data());
+        chowdsp::ConvolutionEngine oldEngine (irSize, blockSize, testIR.data());
+        chowdsp::ConvolutionEngine newEngine (irSize, blockSize, testIR2.data());
+        chowdsp::IRTransfer irTransfer (engine, numCrossfadeBlocks);
+        REQUIRE (! irTransfer.hasNewIR());
+
+        std::vector<float> buffer (40 * blockSize);
+        for (auto& x : buffer)
+            x = rand.nextFloat() * 2.0f - 1.0f;
+        auto oldBuffer = buffer;
+        auto newBuffer = buffer;
+
+        size_t transferSample = 0, crossfadeEndSample = 0;
+        for (size_t ptr = 0; ptr < buffer.size(); ptr += blockSize)
+        {
+            if (ptr == 8 * blockSize)
+            {
+                irTransfer.setNewIR (testIR2.data());
+                REQUIRE (irTransfer.hasNewIR());
+                REQUIRE (irTransfer.transferIR (engine));
+                REQUIRE (! irTransfer.transferIR (engine)); // nothing new to transfer
+                transferSample = ptr;
+            }
+
+            engine.processSamples (buffer.data() + ptr, buffer.data() + ptr, blockSize);
+            oldEngine.processSamples (oldBuffer.data() + ptr, oldBuffer.data() + ptr, blockSize);
+            newEngine.processSamples (newBuffer.data() + ptr, newBuffer.data() + ptr, blockSize);
+
+            if (transferSample > 0 && crossfadeEndSample == 0 && ! engine.isCrossfading())
+                crossfadeEndSample = ptr + blockSize;
+        }
+
+        // the old IR is used right up until the transfer, and the new one once the crossfade has finished
+        REQUIRE (crossfadeEndSample > transferSample + numCrossfadeBlocks * blockSize);
+        for (size_t n = 0; n < transferSample; ++n)
+            REQUIRE (buffer[n] == Catch::Approx { oldBuffer[n] }.margin (1.0e-4f));
+        for (size_t n = crossfadeEndSample; n < buffer.size(); ++n)
+            REQUIRE (buffer[n] == Catch::Approx { newBuffer[n] }.margin (1.0e-4f));
+
+        // in between, the output is always somewhere between the two
+        for (size_t n = transferSample; n < crossfadeEndSample; ++n)
+        {
+            REQUIRE (buffer[n] >= juce::jmin (oldBuffer[n], newBuffer[n]) - 1.0e-4f);
+            REQUIRE (buffer[n] <= juce::jmax (oldBuffer[n], newBuffer[n]) + 1.0e-4f);
+        }
+    }
+
+    SECTION ("Crossfaded Transfer Test (Added Latency)")
+    {
+        using CrossfadeState = chowdsp::ConvolutionEngine<>::CrossfadeState;
+        constexpr size_t irSize = 2000;
+        constexpr size_t blockSize = 64;
+        constexpr size_t numCrossfadeBlocks = 4;
+        constexpr size_t transferSample = 8 * blockSize;
+
+        juce::Random rand { 0x4321 };
+        const auto testIR = createRandomData (irSize, rand);
+        const auto testIR2 = createRandomData (irSize, rand);
+
+        chowdsp::ConvolutionEngine engine (irSize, blockSize, testIR.data());
+        chowdsp::ConvolutionEngine oldEngine (irSize, blockSize, testIR.data());
+        chowdsp::ConvolutionEngine newEngine (irSize, blockSize, testIR2.data());
+        chowdsp::IRTransfer irTransfer (engine, numCrossfadeBlocks);
+
+        auto buffer = createRandomData (40 * blockSize, rand);
+        auto oldBuffer = buffer;
+        auto newBuffer = buffer;
+
+        std::vector<CrossfadeState> states;
+        size_t fadeStartSample = 0, fadeEndSample = 0;
+        for (size_t ptr = 0; ptr < buffer.size(); ptr += blockSize)
+        {
+            if (ptr == transferSample)
+            {
+                irTransfer.setNewIR (testIR2.data());
+                REQUIRE (irTransfer.transferIR (engine));
+            }
+
+            // (the state when the block starts decides how the outgoing block is mixed)
+            if (states.empty() || states.back() != engine.crossfadeState)
+                states.push_back (engine.crossfadeState);
+
+            if (engine.crossfadeState == CrossfadeState::Fading && fadeStartSample == 0)
+                fadeStartSample = ptr;
+
+            engine.processSamplesWithAddedLatency (buffer.data() + ptr, buffer.data() + ptr, blockSize);
+            oldEngine.processSamplesWithAddedLatency (oldBuffer.data() + ptr, oldBuffer.data() + ptr, blockSize);
+            newEngine.processSamplesWithAddedLatency (newBuffer.data() + ptr, newBuffer.data() + ptr, blockSize);
+
+            if (fadeStartSample > 0 && fadeEndSample == 0 && engine.crossfadeState == CrossfadeState::None)
+                fadeEndSample = ptr + blockSize;
+        }
+
+        // the incoming IR needs a whole FFT's worth of blocks to build up its overlap, before the fade can start
+        REQUIRE (states == std::vector<CrossfadeState> { CrossfadeState::None, CrossfadeState::Pending, CrossfadeState::WarmUp, CrossfadeState::Fading, CrossfadeState::None });
+        REQUIRE (fadeStartSample == transferSample + engine.fftSize);
+        REQUIRE (fadeEndSample == fadeStartSample + numCrossfadeBlocks * blockSize);
+
+        // before the fade (including the warm-up), the output only uses the old IR
+        for (size_t n = 0; n < fadeStartSample; ++n)
+            REQUIRE (buffer[n] == Catch::Approx { oldBuffer[n] }.margin (1.0e-4f));
+
+        // during the fade, the output is a linear ramp from the old IR's output to the new one's
+        const auto fadeLength = (float) (fadeEndSample - fadeStartSample);
+        for (size_t n = fadeStartSample; n < fadeEndSample; ++n)
+        {
+            const auto gain = (float) (n - fadeStartSample) / fadeLength;
+            REQUIRE (buffer[n] == Catch::Approx { oldBuffer[n] + gain * (newBuffer[n] - oldBuffer[n]) }.margin (1.0e-4f));
+        }
+
+        // and afterwards, it only uses the new IR
+        for (size_t n = fadeEndSample; n < buffer.size(); ++n)
+            REQUIRE (buffer[n] == Catch::Approx { newBuffer[n] }.margin (1.0e-4f));
+    }
+
     SECTION ("Move Construction Test")
     {
         static constexpr size_t irSize = 1024;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <CatchUtils.h>
+#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
+
+static std::vector<float> createRandomData (size_t size, juce::Random& rand)
+{
+    std::vector<float> data (size);
+    for (auto& x : data)
+        x = rand.nextFloat() * 2.0f - 1.0f;
+    return data;
+}
+
+/** The reference for the convolution engines: a direct convolution, in double precision. */
+static std::vector<double> convolveDirect (const std::vector<float>& input, const std::vector<float>& ir)
+{
+    std::vector<double> output (input.size(), 0.0);
+    for (size_t n = 0; n < input.size(); ++n)
+        for (size_t k = 0; k < ir.size() && k <= n; ++k)
+            output[n] += (double) ir[k] * (double) input[n - k];
+    return output;
+}
+
+/** Calls processBlock (startSample, numSamples) with random block sizes, that don't line up with the partitions. */
+template <typename ProcessBlockFunc>
+static void processInRandomBlocks (size_t totalNumSamples, size_t maxBlockSize, juce::Random& rand, ProcessBlockFunc&& processBlock)
+{
+    for (size_t ptr = 0; ptr < totalNumSamples;)
+    {
+        const auto numSamples = juce::jmin ((size_t) rand.nextInt ({ 1, (int) maxBlockSize + 1 }), totalNumSamples - ptr);
+        processBlock (ptr, numSamples);
+        ptr += numSamples;
+    }
+}
+
+static void checkAccuracy (const std::vector<float>& output, const std::vector<double>& expected, float tolerance)
+{
+    REQUIRE (output.size() == expected.size());
+    for (size_t n = 0; n < output.size(); ++n)
+        REQUIRE (output[n] == Catch::Approx { expected[n] }.margin (tolerance));
+}
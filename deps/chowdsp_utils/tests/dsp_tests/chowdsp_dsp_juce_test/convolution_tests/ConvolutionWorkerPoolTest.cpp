@@ -0,0 +1,353 @@
+#include <CatchUtils.h>
+#include <chowdsp_dsp_utils/chowdsp_dsp_utils.h>
+
+namespace
+{
+struct TestTask : chowdsp::ConvolutionWorkerPool::Task
+{
+    TestTask (int numTaskSlices, int taskID, std::vector<int>& sliceLog)
+        : numSlices (numTaskSlices), id (taskID), log (sliceLog)
+    {
+    }
+
+    bool runSlice() override
+    {
+        // (Catch isn't thread-safe, so this gets checked from the test thread)
+        if (gate != nullptr)
+        {
+            hasStarted.store (true);
+            gate->wait (-1);
+            gate = nullptr;
+        }
+
+        log.push_back (id);
+        return ++numSlicesRun == numSlices;
+    }
+
+    const int numSlices;
+    const int id;
+    int numSlicesRun = 0;
+    std::vector<int>& log;
+
+    // if set, the first slice waits for this
+    juce::WaitableEvent* gate = nullptr;
+    std::atomic<bool> hasStarted { false };
+};
+
+struct TestJob : chowdsp::ConvolutionWorkerPool::Job
+{
+    void runJob() override
+    {
+        // (Catch isn't thread-safe, so this gets checked from the test thread)
+        if (isInJob.exchange (true))
+            ranConcurrently.store (true);
+
+        if (gate != nullptr)
+        {
+            hasStarted.store (true);
+            gate->wait (-1);
+            gate = nullptr;
+        }
+
+        if (latestParams.read (params))
+            lastParams.store (params);
+        if (log != nullptr)
+            log->push_back (id);
+        juce::Thread::sleep (1);
+        numRuns++;
+
+        isInJob.store (false);
+    }
+
+    void setParams (int newParams)
+    {
+        latestParams.write (newParams);
+        requestRun();
+    }
+
+    chowdsp::ConvolutionWorkerPool::LatestParameters<int> latestParams;
+    int params = 0;
+    std::atomic<int> lastParams { 0 };
+    std::atomic<int> numRuns { 0 };
+    std::atomic<bool> isInJob { false };
+    std::atomic<bool> ranConcurrently { false };
+
+    // if set, the job logs its ID here when it runs
+    std::vector<int>* log = nullptr;
+    int id = 0;
+
+    // if set, the next run waits for this
+    juce::WaitableEvent* gate = nullptr;
+    std::atomic<bool> hasStarted { false };
+};
+
+bool waitUntil (const std::function<bool()>& condition)
+{
+    for (int i = 0; i < 5000 && ! condition(); ++i)
+        juce::Thread::sleep (1);
+    return condition();
+}
+} // namespace
+
+TEST_CASE ("Convolution Worker Pool Test", "[dsp][convolution]")
+{
+    SECTION ("Deadline Order Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 1 };
+        REQUIRE (pool.getNumThreads() == 1);
+
+        std::vector<int> log;
+        juce::WaitableEvent gate;
+        TestTask bigTask { 4, 1, log };
+        TestTask smallTask { 1, 2, log };
+        bigTask.gate = &gate;
+        pool.addTask (bigTask);
+        pool.addTask (smallTask);
+
+        // the small task comes in while the big one is running...
+        bigTask.queue (1000.0);
+        REQUIRE (waitUntil ([&] { return bigTask.hasStarted.load(); }));
+        smallTask.queue (10.0);
+        gate.signal();
+
+        // ... and goes next, since it has the nearer deadline
+        REQUIRE (waitUntil ([&] { return bigTask.isFinished() && smallTask.isFinished(); }));
+        REQUIRE (log == std::vector<int> { 1, 2, 1, 1, 1 });
+
+        pool.removeTask (bigTask);
+        pool.removeTask (smallTask);
+    }
+
+    SECTION ("Waiting Task Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 1 };
+
+        std::vector<int> log;
+        juce::WaitableEvent gate;
+        TestTask blockingTask { 1, 1, log };
+        TestTask waitingTask { 1, 2, log };
+        TestTask newTask { 1, 3, log };
+        blockingTask.gate = &gate;
+        pool.addTask (blockingTask);
+        pool.addTask (waitingTask);
+        pool.addTask (newTask);
+
+        blockingTask.queue (0.0);
+        REQUIRE (waitUntil ([&] { return blockingTask.hasStarted.load(); }));
+
+        // a task with a long deadline that has been waiting for longer than that goes
+        // before a task with a short deadline that has only just come in
+        const auto waitingTaskQueueTime = juce::Time::getMillisecondCounterHiRes();
+        waitingTask.queue (20.0);
+        REQUIRE (waitUntil ([&] { return juce::Time::getMillisecondCounterHiRes() > waitingTaskQueueTime + 20.0; }));
+        newTask.queue (10.0);
+        gate.signal();
+
+        REQUIRE (waitUntil ([&] { return waitingTask.isFinished() && newTask.isFinished(); }));
+        REQUIRE (log == std::vector<int> { 1, 2, 3 });
+
+        pool.removeTask (blockingTask);
+        pool.removeTask (waitingTask);
+        pool.removeTask (newTask);
+    }
+
+    SECTION ("Claim Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 1 };
+
+        std::vector<int> log;
+        juce::WaitableEvent gate;
+        TestTask blockingTask { 1, 1, log };
+        TestTask task { 2, 2, log };
+        blockingTask.gate = &gate;
+        pool.addTask (blockingTask);
+        pool.addTask (task);
+
+        blockingTask.queue (1.0);
+        REQUIRE (waitUntil ([&] { return blockingTask.hasStarted.load(); }));
+
+        // the worker is busy, so the task can be taken back, and finished here
+        task.queue (2.0);
+        REQUIRE (task.tryClaim());
+        while (! task.runSlice())
+        {
+        }
+        task.release();
+        REQUIRE (task.isFinished());
+
+        // but not while a worker is in the middle of it
+        REQUIRE (! blockingTask.tryClaim());
+        gate.signal();
+        REQUIRE (waitUntil ([&] { return blockingTask.isFinished(); }));
+        REQUIRE (log == std::vector<int> { 2, 2, 1 });
+
+        pool.removeTask (blockingTask);
+        pool.removeTask (task);
+    }
+
+    SECTION ("Remove Task Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 1 };
+
+        std::vector<int> log;
+        juce::WaitableEvent gate;
+        TestTask blockingTask { 1, 1, log };
+        TestTask task { 1, 2, log };
+        TestTask laterTask { 1, 3, log };
+        blockingTask.gate = &gate;
+        pool.addTask (blockingTask);
+        pool.addTask (task);
+        pool.addTask (laterTask);
+
+        blockingTask.queue (1.0);
+        REQUIRE (waitUntil ([&] { return blockingTask.hasStarted.load(); }));
+        task.queue (2.0);
+        laterTask.queue (1000.0);
+
+        // the removed task would have gone before the later one
+        pool.removeTask (task);
+        REQUIRE (task.isFinished());
+        gate.signal();
+        REQUIRE (waitUntil ([&] { return blockingTask.isFinished() && laterTask.isFinished(); }));
+        const auto expectedLog = std::vector<int> { 1, 3 };
+        REQUIRE_MESSAGE (log == expectedLog, "Task was run after being removed from the pool!");
+
+        pool.removeTask (blockingTask);
+        pool.removeTask (laterTask);
+    }
+
+    SECTION ("Latest Parameters Test")
+    {
+        chowdsp::ConvolutionWorkerPool::LatestParameters<int> latestParams;
+        int params = 0;
+        REQUIRE (! latestParams.hasNewValue());
+        REQUIRE (! latestParams.read (params));
+
+        for (int i = 1; i <= 10; ++i)
+            latestParams.write (i);
+
+        REQUIRE (latestParams.hasNewValue());
+        REQUIRE (latestParams.read (params));
+        REQUIRE (params == 10);
+        REQUIRE (! latestParams.read (params));
+    }
+
+    SECTION ("Job Priority Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 1 };
+
+        std::vector<int> log;
+        juce::WaitableEvent gate;
+        TestTask blockingTask { 1, 1, log };
+        TestTask task { 1, 3, log };
+        TestJob job;
+        job.log = &log;
+        job.id = 2;
+        blockingTask.gate = &gate;
+        pool.addTask (blockingTask);
+        pool.addTask (task);
+        pool.addJob (job);
+
+        blockingTask.queue (0.0);
+        REQUIRE (waitUntil ([&] { return blockingTask.hasStarted.load(); }));
+
+        // the job has no deadline, so a task that was queued after it still goes first
+        job.requestRun();
+        task.queue (1000.0);
+        REQUIRE (pool.getQueueDepth() == 2);
+        gate.signal();
+
+        REQUIRE (waitUntil ([&] { return ! pool.isBusy(); }));
+        REQUIRE (log == std::vector<int> { 1, 3, 2 });
+
+        pool.removeTask (blockingTask);
+        pool.removeTask (task);
+        pool.removeJob (job);
+    }
+
+    SECTION ("Coalescing Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 2 };
+        REQUIRE (pool.getNumThreads() == 2);
+
+        std::array<TestJob, 4> jobs;
+        for (auto& job : jobs)
+            pool.addJob (job);
+
+        static constexpr int numRequests = 500;
+        for (int i = 1; i <= numRequests; ++i)
+            for (auto& job : jobs)
+                job.setParams (i);
+
+        REQUIRE (pool.getQueueDepth() <= (int) jobs.size());
+        REQUIRE (waitUntil ([&] { return ! pool.isBusy(); }));
+        REQUIRE (pool.getQueueDepth() == 0);
+
+        for (auto& job : jobs)
+        {
+            REQUIRE_MESSAGE (job.numRuns.load() < numRequests, "Requests are not being coalesced!");
+            REQUIRE_MESSAGE (job.lastParams.load() == numRequests, "Job did not use the latest parameters!");
+            REQUIRE_MESSAGE (! job.ranConcurrently.load(), "Job was run on more than one thread at once!");
+        }
+
+        REQUIRE (pool.getLastLatencyMs() > 0.0);
+        REQUIRE (pool.getMaxLatencyMs() >= pool.getLastLatencyMs());
+        pool.resetLatencyStats();
+        REQUIRE (pool.getMaxLatencyMs() == 0.0);
+
+        for (auto& job : jobs)
+            pool.removeJob (job);
+    }
+
+    SECTION ("Latency Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 1 };
+
+        juce::WaitableEvent gate;
+        TestJob job;
+        job.gate = &gate;
+        pool.addJob (job);
+
+        const auto firstRequestTime = juce::Time::getMillisecondCounterHiRes();
+        job.setParams (1);
+        REQUIRE (waitUntil ([&] { return job.hasStarted.load(); }));
+        REQUIRE (waitUntil ([&] { return juce::Time::getMillisecondCounterHiRes() > firstRequestTime + 20.0; }));
+
+        // a request that comes in while the job is running is for the next run,
+        // so it mustn't make the current run look quicker than it was
+        job.setParams (2);
+        gate.signal();
+
+        REQUIRE (waitUntil ([&] { return ! pool.isBusy(); }));
+        REQUIRE (job.numRuns.load() == 2);
+        REQUIRE (job.lastParams.load() == 2);
+        REQUIRE (pool.getMaxLatencyMs() >= 20.0);
+        REQUIRE (pool.getLastLatencyMs() < pool.getMaxLatencyMs());
+
+        pool.removeJob (job);
+    }
+
+    SECTION ("Remove Job Test")
+    {
+        chowdsp::ConvolutionWorkerPool pool { 1 };
+        TestJob job, laterJob;
+        pool.addJob (job);
+        pool.addJob (laterJob);
+
+        job.setParams (1);
+        REQUIRE (waitUntil ([&] { return ! pool.isBusy(); }));
+        REQUIRE (job.numRuns.load() == 1);
+
+        pool.removeJob (job);
+        job.setParams (2);
+        REQUIRE (pool.getQueueDepth() == 0);
+
+        // the removed job would have gone before the later one
+        laterJob.setParams (1);
+        REQUIRE (waitUntil ([&] { return ! pool.isBusy(); }));
+        REQUIRE (laterJob.numRuns.load() == 1);
+        REQUIRE_MESSAGE (job.numRuns.load() == 1, "Job was run after being removed from the pool!");
+
+        pool.removeJob (laterJob);
+    }
+}
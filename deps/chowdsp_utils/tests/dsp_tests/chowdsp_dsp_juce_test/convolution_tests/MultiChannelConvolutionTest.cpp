@@ -0,0 +1,83 @@
+#include "ConvolutionTestUtils.h"
+
+using Engine = chowdsp::MultiChannelConvolutionEngine<>;
+
+static void accuracyTest (size_t numChannels, const std::vector<Engine::Route>& routes, size_t irSize, size_t maxBlockSize)
+{
+    juce::Random rand { 0x1234 };
+    Engine engine { irSize, maxBlockSize, numChannels, numChannels, routes };
+
+    std::vector<std::vector<float>> irs;
+    for (size_t i = 0; i < engine.getNumIRs(); ++i)
+    {
+        irs.push_back (createRandomData (irSize, rand));
+        engine.setNewIR (i, irs.back().data());
+    }
+
+    const auto numSamples = 2 * irSize;
+    std::vector<std::vector<float>> buffers;
+    for (size_t ch = 0; ch < numChannels; ++ch)
+        buffers.push_back (createRandomData (numSamples, rand));
+
+    std::vector<std::vector<double>> expected (numChannels, std::vector<double> (numSamples, 0.0));
+    for (const auto& route : routes)
+    {
+        const auto routeOutput = convolveDirect (buffers[route.inputChannel], irs[route.irIndex]);
+        for (size_t n = 0; n < numSamples; ++n)
+            expected[route.outputChannel][n] += routeOutput[n];
+    }
+
+    std::vector<float*> channelPointers (numChannels);
+    auto processBlock = [&] (size_t startSample, size_t numSamplesToProcess)
+    {
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            channelPointers[ch] = buffers[ch].data() + startSample;
+        engine.processSamples (channelPointers.data(), channelPointers.data(), numSamplesToProcess);
+    };
+    processInRandomBlocks (numSamples, maxBlockSize, rand, processBlock);
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+        checkAccuracy (buffers[ch], expected[ch], 1.0e-3f);
+}
+
+TEST_CASE ("Multi-Channel Convolution Test", "[dsp][convolution]")
+{
+    SECTION ("True Stereo Accuracy Test")
+    {
+        accuracyTest (2, Engine::getTrueStereoRoutes(), 3000, 64);
+    }
+
+    SECTION ("Parallel Accuracy Test (Odd Channel Count)")
+    {
+        accuracyTest (3, Engine::getParallelRoutes (3), 2500, 200);
+    }
+
+    SECTION ("Short IR Test")
+    {
+        accuracyTest (2, Engine::getParallelRoutes (2), 50, 64);
+    }
+
+    SECTION ("Matches Single-Channel Engine")
+    {
+        constexpr size_t irSize = 1000;
+        constexpr size_t blockSize = 128;
+        juce::Random rand { 0x5678 };
+        const auto ir = createRandomData (irSize, rand);
+
+        chowdsp::ConvolutionEngine<> monoEngine { irSize, blockSize, ir.data() };
+        Engine engine { irSize, blockSize, 1, 1, Engine::getParallelRoutes (1) };
+        engine.setNewIR (0, ir.data());
+
+        auto monoBuffer = createRandomData (32 * blockSize, rand);
+        auto buffer = monoBuffer;
+        for (size_t ptr = 0; ptr < buffer.size(); ptr += blockSize)
+        {
+            monoEngine.processSamples (monoBuffer.data() + ptr, monoBuffer.data() + ptr, blockSize);
+            auto* channelPointer = buffer.data() + ptr;
+            engine.processSamples (&channelPointer, &channelPointer, blockSize);
+        }
+
+        for (size_t n = 0; n < buffer.size(); ++n)
+            REQUIRE (buffer[n] == Catch::Approx { monoBuffer[n] }.margin (1.0e-4f));
+    }
+}
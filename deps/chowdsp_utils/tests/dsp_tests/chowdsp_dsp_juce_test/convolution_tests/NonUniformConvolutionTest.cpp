@@ -0,0 +1,98 @@
+#include "ConvolutionTestUtils.h"
+
+static std::vector<float> createTestIR (size_t size)
+{
+    juce::Random rand { 0x1234 };
+    auto ir = createRandomData (size, rand);
+    for (size_t i = 0; i < size; ++i)
+        ir[i] *= std::exp (-(float) i / ((float) size * 0.2f));
+    return ir;
+}
+
+static void accuracyTest (size_t irSize, size_t maxBlockSize, bool useBackgroundThread, bool isNonRealtime = true)
+{
+    const auto ir = createTestIR (irSize);
+    chowdsp::NonUniformConvolutionEngine<> engine { irSize, maxBlockSize, ir.data(), 2048, useBackgroundThread };
+    engine.setNonRealtime (isNonRealtime);
+
+    juce::Random rand { 0x5678 };
+    auto buffer = createRandomData (2 * irSize, rand);
+    const auto expected = convolveDirect (buffer, ir);
+
+    auto processBlock = [&] (size_t startSample, size_t numSamples)
+    {
+        engine.processSamples (buffer.data() + startSample, buffer.data() + startSample, numSamples);
+    };
+    processInRandomBlocks (buffer.size(), maxBlockSize, rand, processBlock);
+
+    if (engine.getNumMissedTailResults() > 0)
+    {
+        // a stage was silent for a partition, so the output can't be exact, but it mustn't blow up
+        REQUIRE (! isNonRealtime);
+        for (auto& y : buffer)
+            REQUIRE (std::isfinite (y));
+        return;
+    }
+
+    checkAccuracy (buffer, expected, 1.0e-3f);
+}
+
+TEST_CASE ("Non-Uniform Convolution Test", "[dsp][convolution]")
+{
+    SECTION ("Partitioning")
+    {
+        chowdsp::NonUniformConvolutionEngine<> engine { 48000, 64, nullptr, 4096, false };
+        REQUIRE (engine.headNumSamples == 256);
+        REQUIRE (engine.getNumTailStages() == 6);
+        for (size_t i = 0; i < engine.getNumTailStages(); ++i)
+            REQUIRE (engine.getTailPartitionSize (i) == ((size_t) 128 << i));
+    }
+
+    SECTION ("Short IR")
+    {
+        chowdsp::NonUniformConvolutionEngine<> engine { 200, 64, nullptr };
+        REQUIRE (engine.headNumSamples == 200);
+        REQUIRE (engine.getNumTailStages() == 0);
+    }
+
+    SECTION ("Accuracy Test")
+    {
+        accuracyTest (12000, 64, false);
+    }
+
+    SECTION ("Accuracy Test (Background Thread)")
+    {
+        accuracyTest (12000, 64, true);
+    }
+
+    SECTION ("Accuracy Test (Non-Power-of-2 Block Size)")
+    {
+        accuracyTest (9000, 200, true);
+    }
+
+    SECTION ("Accuracy Test (Real-Time)")
+    {
+        // late results are computed on the audio thread, so unless a worker was caught in the middle of one, the output is exact
+        accuracyTest (12000, 64, true, false);
+    }
+
+    SECTION ("Reset Test")
+    {
+        constexpr size_t irSize = 5000;
+        const auto ir = createTestIR (irSize);
+        chowdsp::NonUniformConvolutionEngine<> engine { irSize, 128, ir.data() };
+        engine.setNonRealtime (true);
+
+        std::vector<float> buffer (irSize, 1.0f);
+        engine.processSamples (buffer.data(), buffer.data(), irSize);
+        engine.reset();
+
+        std::fill (buffer.begin(), buffer.end(), 0.0f);
+        buffer[0] = 1.0f;
+        for (size_t ptr = 0; ptr < irSize; ptr += 128)
+            engine.processSamples (buffer.data() + ptr, buffer.data() + ptr, juce::jmin ((size_t) 128, irSize - ptr));
+
+        for (size_t n = 0; n < irSize; ++n)
+            REQUIRE (buffer[n] == Catch::Approx { ir[n] }.margin (1.0e-5f));
+    }
+}
@@ -129,6 +129,39 @@ TEST_CASE ("Variable Oversampling Test", "[dsp][resampling]")
         checkOSFactor (16, "OS factor \"same as real-time\" is incorrect!");
     }
 
+    SECTION ("Parameter Handles Test")
+    {
+        TestPlugin testPlugin;
+        testPlugin.setNonRealtime (true);
+
+        using Oversampling = chowdsp::VariableOversampling<float>;
+        auto& vts = testPlugin.getVTS();
+        const juce::String& paramPrefix = "os";
+
+        Oversampling::ParameterHandles params;
+        params.osFactor = dynamic_cast<juce::AudioParameterChoice*> (vts.getParameter (paramPrefix + "_factor"));
+        params.osMode = dynamic_cast<juce::AudioParameterChoice*> (vts.getParameter (paramPrefix + "_mode"));
+        params.osRenderFactor = dynamic_cast<juce::AudioParameterChoice*> (vts.getParameter (paramPrefix + "_render_factor"));
+        params.osRenderMode = dynamic_cast<juce::AudioParameterChoice*> (vts.getParameter (paramPrefix + "_render_mode"));
+        params.osRenderLikeRealtime = dynamic_cast<juce::AudioParameterBool*> (vts.getParameter (paramPrefix + "_render_like_realtime"));
+
+        REQUIRE (params.osFactor->choices == Oversampling::getOSFactorChoices());
+        REQUIRE (params.osMode->choices == Oversampling::getOSModeChoices());
+
+        Oversampling oversampling { testPlugin, params };
+        oversampling.prepareToPlay (_sampleRate, _blockSize, _numChannels);
+        REQUIRE_MESSAGE (oversampling.getOSFactor() == 2, "Initial OS factor incorrect!");
+
+        *params.osFactor = 3;
+        REQUIRE (oversampling.updateOSFactor());
+        REQUIRE_MESSAGE (oversampling.getOSFactor() == 8, "New OS factor incorrect!");
+
+        *params.osRenderLikeRealtime = false;
+        *params.osRenderFactor = 2;
+        REQUIRE (oversampling.updateOSFactor());
+        REQUIRE_MESSAGE (oversampling.getOSFactor() == 4, "Render OS factor incorrect!");
+    }
+
     SECTION ("Latency Test")
     {
         TestPlugin testPlugin;
@@ -1,33 +1,34 @@
 #include <CatchUtils.h>
 #include <chowdsp_filters/chowdsp_filters.h>
 
+template <typename T = float>
 static void decimationFilterCompare (int filterOrder, int decimationFactor, int numChannels)
 {
     const auto numSamples = decimationFactor * 12;
     const auto halfSamples = numSamples / 2;
 
-    chowdsp::Buffer<float> bufferIn { numChannels, numSamples };
+    chowdsp::Buffer<T> bufferIn { numChannels, numSamples };
     for (auto [ch, data] : chowdsp::buffer_iters::channels (bufferIn))
         for (auto [n, x] : chowdsp::enumerate (data))
-            x = static_cast<float> (n + (size_t) ch);
+            x = static_cast<T> (n + (size_t) ch);
 
-    std::vector coeffs ((size_t) filterOrder, 0.0f);
+    std::vector coeffs ((size_t) filterOrder, T {});
     for (auto [k, h] : chowdsp::enumerate (coeffs))
-        h = static_cast<float> (k);
+        h = static_cast<T> (k);
 
-    chowdsp::FIRFilter<float> referenceFilter { filterOrder };
+    chowdsp::FIRFilter<T> referenceFilter { filterOrder };
     referenceFilter.prepare (numChannels);
     referenceFilter.setCoefficients (coeffs.data());
 
-    chowdsp::Buffer<float> referenceBufferOut { numChannels, numSamples };
+    chowdsp::Buffer<T> referenceBufferOut { numChannels, numSamples };
     referenceFilter.processBlock (chowdsp::BufferView { bufferIn, 0, halfSamples },
                                   chowdsp::BufferView { referenceBufferOut, 0, halfSamples });
     referenceFilter.processBlock (chowdsp::BufferView { bufferIn, halfSamples, halfSamples },
                                   chowdsp::BufferView { referenceBufferOut, halfSamples, halfSamples });
 
-    chowdsp::FIRPolyphaseDecimator<float> decimatorFilter;
+    chowdsp::FIRPolyphaseDecimator<T> decimatorFilter;
     decimatorFilter.prepare (decimationFactor, numChannels, numSamples, coeffs);
-    chowdsp::Buffer<float> testBufferOut { numChannels, numSamples / decimationFactor };
+    chowdsp::Buffer<T> testBufferOut { numChannels, numSamples / decimationFactor };
     decimatorFilter.processBlock (chowdsp::BufferView { bufferIn, 0, halfSamples },
                                   chowdsp::BufferView { testBufferOut, 0, halfSamples / decimationFactor });
     decimatorFilter.processBlock (chowdsp::BufferView { bufferIn, halfSamples, halfSamples },
@@ -54,4 +55,37 @@ TEST_CASE ("FIR Polyphase Decimator Test", "[dsp][filters][fir][anti-aliasing]")
 
     decimationFilterCompare (32, 4, 2);
     decimationFilterCompare (33, 4, 2);
+
+    decimationFilterCompare<double> (16, 3, 4);
+    decimationFilterCompare<double> (33, 4, 2);
+}
+
+TEST_CASE ("FIR Polyphase Decimator Reset Test", "[dsp][filters][fir][anti-aliasing]")
+{
+    static constexpr int numSamples = 24;
+
+    std::vector coeffs (25, 0.0f);
+    for (auto [k, h] : chowdsp::enumerate (coeffs))
+        h = 1.0f / static_cast<float> (k + 1);
+
+    chowdsp::Buffer<float> bufferIn { 2, numSamples * 3 };
+    for (auto [ch, data] : chowdsp::buffer_iters::channels (bufferIn))
+        for (auto [n, x] : chowdsp::enumerate (data))
+            x = std::sin (0.1f * static_cast<float> (n + (size_t) ch));
+
+    chowdsp::FIRPolyphaseDecimator<float> filter;
+    filter.prepare (3, 2, numSamples * 3, coeffs);
+
+    chowdsp::Buffer<float> firstOut { 2, numSamples };
+    chowdsp::Buffer<float> secondOut { 2, numSamples };
+    filter.processBlock (bufferIn, firstOut);
+    filter.reset();
+    filter.processBlock (bufferIn, secondOut);
+
+    for (const auto [ch, firstData, secondData] : chowdsp::buffer_iters::zip_channels (std::as_const (firstOut),
+                                                                                       std::as_const (secondOut)))
+    {
+        for (const auto [first, second] : chowdsp::zip (firstData, secondData))
+            REQUIRE (second == first);
+    }
 }
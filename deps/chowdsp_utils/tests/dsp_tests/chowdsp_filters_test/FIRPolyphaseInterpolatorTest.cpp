@@ -1,26 +1,27 @@
 #include <CatchUtils.h>
 #include <chowdsp_filters/chowdsp_filters.h>
 
+template <typename T = float>
 static void interpolationFilterCompare (int filterOrder, int interpolationFactor, int numChannels)
 {
     const auto numSamples = 12;
     const auto halfSamples = numSamples / 2;
 
-    chowdsp::Buffer<float> bufferIn { numChannels, numSamples };
+    chowdsp::Buffer<T> bufferIn { numChannels, numSamples };
     for (auto [ch, data] : chowdsp::buffer_iters::channels (bufferIn))
         for (auto [n, x] : chowdsp::enumerate (data))
-            x = static_cast<float> (n + (size_t) ch);
+            x = static_cast<T> (n + (size_t) ch);
 
-    std::vector coeffs ((size_t) filterOrder, 0.0f);
+    std::vector coeffs ((size_t) filterOrder, T {});
     for (auto [k, h] : chowdsp::enumerate (coeffs))
-        h = static_cast<float> (k);
+        h = static_cast<T> (k);
 
-    chowdsp::FIRFilter<float> referenceFilter { filterOrder };
+    chowdsp::FIRFilter<T> referenceFilter { filterOrder };
     referenceFilter.prepare (numChannels);
     referenceFilter.setCoefficients (coeffs.data());
 
-    chowdsp::Buffer<float> referenceBufferIn { numChannels, numSamples * interpolationFactor };
-    chowdsp::Buffer<float> referenceBufferOut { numChannels, numSamples * interpolationFactor };
+    chowdsp::Buffer<T> referenceBufferIn { numChannels, numSamples * interpolationFactor };
+    chowdsp::Buffer<T> referenceBufferOut { numChannels, numSamples * interpolationFactor };
     referenceBufferIn.clear();
     for (auto [ch, data] : chowdsp::buffer_iters::channels (std::as_const (bufferIn)))
         for (auto [n, x] : chowdsp::enumerate (data))
@@ -30,9 +31,9 @@ static void interpolationFilterCompare (int filterOrder, int interpolationFactor
     referenceFilter.processBlock (chowdsp::BufferView { referenceBufferIn, halfSamples * interpolationFactor, halfSamples * interpolationFactor },
                                   chowdsp::BufferView { referenceBufferOut, halfSamples * interpolationFactor, halfSamples * interpolationFactor });
 
-    chowdsp::FIRPolyphaseInterpolator<float> interpolatorFilter;
+    chowdsp::FIRPolyphaseInterpolator<T> interpolatorFilter;
     interpolatorFilter.prepare (interpolationFactor, numChannels, numSamples, coeffs);
-    chowdsp::Buffer<float> testBufferOut { numChannels, numSamples * interpolationFactor };
+    chowdsp::Buffer<T> testBufferOut { numChannels, numSamples * interpolationFactor };
     interpolatorFilter.processBlock (chowdsp::BufferView { bufferIn, 0, halfSamples },
                                      chowdsp::BufferView { testBufferOut, 0, halfSamples * interpolationFactor });
     interpolatorFilter.processBlock (chowdsp::BufferView { bufferIn, halfSamples, halfSamples },
@@ -56,4 +57,37 @@ TEST_CASE ("FIR Polyphase Interpolator Test", "[dsp][filters][fir][anti-aliasing
 
     interpolationFilterCompare (32, 4, 2);
     interpolationFilterCompare (33, 4, 2);
+
+    interpolationFilterCompare<double> (16, 3, 4);
+    interpolationFilterCompare<double> (33, 4, 2);
+}
+
+TEST_CASE ("FIR Polyphase Interpolator Reset Test", "[dsp][filters][fir][anti-aliasing]")
+{
+    static constexpr int numSamples = 24;
+
+    std::vector coeffs (25, 0.0f);
+    for (auto [k, h] : chowdsp::enumerate (coeffs))
+        h = 1.0f / static_cast<float> (k + 1);
+
+    chowdsp::Buffer<float> bufferIn { 2, numSamples };
+    for (auto [ch, data] : chowdsp::buffer_iters::channels (bufferIn))
+        for (auto [n, x] : chowdsp::enumerate (data))
+            x = std::sin (0.1f * static_cast<float> (n + (size_t) ch));
+
+    chowdsp::FIRPolyphaseInterpolator<float> filter;
+    filter.prepare (3, 2, numSamples, coeffs);
+
+    chowdsp::Buffer<float> firstOut { 2, numSamples * 3 };
+    chowdsp::Buffer<float> secondOut { 2, numSamples * 3 };
+    filter.processBlock (bufferIn, firstOut);
+    filter.reset();
+    filter.processBlock (bufferIn, secondOut);
+
+    for (const auto [ch, firstData, secondData] : chowdsp::buffer_iters::zip_channels (std::as_const (firstOut),
+                                                                                       std::as_const (secondOut)))
+    {
+        for (const auto [first, second] : chowdsp::zip (firstData, secondData))
+            REQUIRE (second == first);
+    }
 }